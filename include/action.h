@@ -0,0 +1,78 @@
+/**
+ * @file
+ * @date   16-Oct-2026
+ * @brief The game_action structure, a non-interactive list of the active character's legal actions, and
+ *        accompanying function headers
+*/
+
+#ifndef ACTION_H
+#define ACTION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "game_state.h"
+#include "map/map.h"
+#include "map/room.h"
+
+// Most actions get_legal_actions can list for one character. Ripley's ability (5 characters times 10
+// destinations) and giving (4 characters times 3 items, a COOLANT CANISTER and 9 amounts of Scrap) add
+// up to 102, the other actions to at most 73
+#define MAX_LEGAL_ACTIONS 192
+
+// Most keys it takes to answer the menus of one action, like g, a character, s, and an amount
+#define MAX_ACTION_KEYS 4
+
+// Kinds of actions the active character can take from the action menu
+typedef enum {
+    // Move to `room`
+    ACTION_MOVE,
+    // Pick up `amount` Scrap
+    ACTION_PICKUP_SCRAP,
+    // Pick up the item in slot `item` of the room
+    ACTION_PICKUP_ITEM,
+    // Drop `amount` Scrap
+    ACTION_DROP_SCRAP,
+    // Drop the held item in slot `item`
+    ACTION_DROP_ITEM,
+    // Drop the COOLANT CANISTER
+    ACTION_DROP_COOLANT,
+    // Craft an item of type `item`
+    ACTION_CRAFT,
+    // Use the held item in slot `item`, on `room` for a MOTION TRACKER or GRAPPLE GUN
+    ACTION_USE_ITEM,
+    // Give the held item in slot `item` to `character`
+    ACTION_GIVE_ITEM,
+    // Give the COOLANT CANISTER to `character`
+    ACTION_GIVE_COOLANT,
+    // Give `amount` Scrap to `character`
+    ACTION_GIVE_SCRAP,
+    // Use the character's ability. Ripley moves `character` to `room`
+    ACTION_ABILITY,
+    // Discard a Scrap to look at the next encounter, during BLOW IT OUT INTO SPACE
+    ACTION_VIEW_ENCOUNTER,
+    // End the turn early
+    ACTION_END_TURN
+} ACTION_TYPES;
+
+#define NUM_ACTION_TYPES 14
+
+// One legal action, with the keys that take it. Fields an action doesn't use are -1, or NO_ROOM for `room`
+typedef struct game_action {
+    // One of ACTION_TYPES
+    int8_t type;
+    // Room item slot for pickups, item type for crafting, held item slot otherwise
+    int8_t item;
+    // Amount of Scrap
+    int8_t amount;
+    // Index of the character in the game's turn order
+    int8_t character;
+    room_id room;
+    // Keys that answer the action menu and every menu after it to take this action, NUL-terminated.
+    // Lambert's ability asks whether to discard the encounter once it is seen, which isn't included
+    char keys[MAX_ACTION_KEYS + 1];
+} game_action;
+
+int get_legal_actions(const game_state *state, const map *game_map, search_scratch *scratch, game_action *actions);
+
+#endif
@@ -10,15 +10,38 @@
 
 #include <argp.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
+// Key for --compile-map, which has no short option
+#define COMPILE_MAP_KEY 256
+// Key for --seed, which has no short option
+#define SEED_KEY 257
+// Keys for the crew AI's options, which have no short options
+#define AI_KEY 258
+#define AI_ITERATIONS_KEY 259
+#define AI_TIME_KEY 260
+#define AI_THREADS_KEY 261
+// Keys for --record and --replay, which have no short options
+#define RECORD_KEY 262
+#define REPLAY_KEY 263
+// Keys for --save and --load, which have no short options
+#define SAVE_KEY 264
+#define LOAD_KEY 265
+// Keys for aftn-sim's --sweep and --margin, which have no short options
+#define SWEEP_KEY 266
+#define MARGIN_KEY 267
+
 // Structure to hold command line arguments
 typedef struct arguments {
     // Number of players (TODO : unimplemented)
     int n_players;
     // Number of characters
     int n_characters;
+    // Characters to play instead of asking which to pick, a bit (1 << i) for each index i in default_characters,
+    // 0 to ask. When set, it overrides n_characters
+    int crew;
 
     // Whether or not to use Ash for a more challenging game
     bool use_ash;
@@ -30,8 +53,63 @@ typedef struct arguments {
 
     // A path to a map file
     char game_file[256];
+
+    // Whether or not to compile a map file into a binary map image, then exit
+    bool compile_map;
+    // The map file to compile
+    char compile_map_input[256];
+    // The path to write the compiled map image to
+    char compile_map_output[256];
+
+    // Whether or not to play without printing anything
+    bool quiet;
+    // A file of input to play before reading from the terminal, empty to read from the terminal only
+    char input_script[256];
+    // Whether or not a bot makes random decisions instead of reading from the terminal
+    bool bot;
+
+    // Seed for the game's random events
+    uint64_t seed;
+
+    // Number of characters, at the end of the turn order, played by the crew AI
+    int ai_characters;
+    // Rollouts the crew AI plays per decision, 0 for no limit
+    int ai_iterations;
+    // Milliseconds the crew AI searches per decision, 0 for no limit
+    int ai_time;
+    // Number of threads the crew AI searches on
+    int ai_threads;
+
+    // A file to record the game's replay log to, empty to not record
+    char record_file[256];
+    // A replay log to replay and check instead of playing, empty to play
+    char replay_file[256];
+
+    // The save file the game saves to and loads from when asked
+    char save_file[256];
+    // A save file to resume instead of starting a new game, empty for a new game
+    char load_file[256];
 } arguments;
 
+// Structure to hold aftn-sim's command line arguments
+typedef struct sim_arguments {
+    // Settings for every simulated game
+    arguments game;
+
+    // Number of games to play
+    long games;
+    // Number of threads to play them on
+    int threads;
+    // Number of rounds to play before giving up on a game, 0 for no limit
+    int max_rounds;
+
+    // A directory of maps to sweep every crew, with and without Ash, over, empty to play one batch
+    char sweep_dir[256];
+    // Largest half-width of the 95% confidence interval of a sweep configuration's win rate
+    double margin;
+} sim_arguments;
+
 error_t parse_opt(int key, char *arg, struct argp_state *state);
+error_t parse_sim_opt(int key, char *arg, struct argp_state *state);
 
 #endif
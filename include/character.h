@@ -9,13 +9,16 @@
 #define CHARACTER_H
 
 #include <stdbool.h>
+#include <stdio.h>
 
 #include "item.h"
-#include "manager.h"
 #include "map/map.h"
 #include "map/room.h"
 #include "utils.h"
 
+// The game manager is defined in manager.h
+struct game_manager;
+
 // A structure to pass data from a character's ability_function to the game loop
 typedef struct ability_output {
     // Whether or not this ability used an action
@@ -47,10 +50,10 @@ struct character {
 
     // The number of items this character holds
     int num_items;
-    // General held items (not coolant)
-    item *held_items[3];
-    // A held item that can only be a coolant
-    item *coolant;
+    // Handles of general held items (not coolant), NO_ITEM for empty slots
+    item_id held_items[3];
+    // Handle of a held item that can only be a coolant, NO_ITEM if there is none
+    item_id coolant;
 
     // Pointer to the room this character is currently in
     room *current_room;
@@ -58,23 +61,23 @@ struct character {
     // A text description of this character's ability
     char ability_description[128];
     // The pointer to this character's ability function
-    ability_output *(*ability_function)(map *, character **, character *);
+    ability_output *(*ability_function)(struct game_manager *, character *);
 };
 
-bool character_has_item(character *c, ITEM_TYPES type);
+bool character_has_item(const struct game_manager *manager, const character *c, ITEM_TYPES type);
 
-ability_output *ripley_ability(map *game_map, character *characters[5], character *active_character);
-ability_output *dallas_ability(map *game_map, character *characters[5], character *active_character);
-ability_output *parker_ability(map *game_map, character *characters[5], character *active_character);
-ability_output *brett_ability(map *game_map, character *characters[5], character *active_character);
-ability_output *lambert_ability(map *game_map, character *characters[5], character *active_character);
+ability_output *ripley_ability(struct game_manager *manager, character *active_character);
+ability_output *dallas_ability(struct game_manager *manager, character *active_character);
+ability_output *parker_ability(struct game_manager *manager, character *active_character);
+ability_output *brett_ability(struct game_manager *manager, character *active_character);
+ability_output *lambert_ability(struct game_manager *manager, character *active_character);
 
-extern character characters[5];
+extern const character default_characters[5];
 
-ability_output *new_ability_output();
+ability_output *new_ability_output(struct game_manager *manager);
 
-void use_item(character *c, item *i);
+void use_item(struct game_manager *manager, character *c, item_id id);
 
-void print_inventory(character *c);
+void print_inventory(struct game_manager *manager, character *c);
 
 #endif
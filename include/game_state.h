@@ -0,0 +1,122 @@
+/**
+ * @file
+ * @date   16-Oct-2026
+ * @brief A flat, pointer-free copy of everything that changes during a game, and accompanying function headers
+*/
+
+#ifndef GAME_STATE_H
+#define GAME_STATE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "manager.h"
+#include "map/encounter.h"
+#include "map/room.h"
+#include "objective.h"
+#include "utils.h"
+
+// An item in a game_state, NO_ITEM if the slot is empty
+typedef struct item_snapshot {
+    int8_t type;
+    // Number of uses left, -1 for unlimited
+    int8_t uses;
+} item_snapshot;
+
+// The Scrap, items, and event of a room in a game_state
+typedef struct room_snapshot {
+    uint16_t num_scrap;
+    bool has_event;
+    uint8_t num_items;
+    item_snapshot room_items[NUM_ROOM_ITEMS];
+} room_snapshot;
+
+// A character in play in a game_state
+typedef struct character_snapshot {
+    // Index of the character in default_characters
+    int8_t roster_index;
+    int8_t current_actions;
+    int8_t self_destruct_tracker;
+    int8_t num_items;
+    uint16_t num_scrap;
+    room_id current_room;
+    item_snapshot held_items[3];
+    item_snapshot coolant;
+} character_snapshot;
+
+// Everything about a game that changes while it is played, with rooms, items, characters and objectives
+// stored by index instead of by pointer. A state is one allocation of game_state_size bytes, so states
+// of games on the same map can be copied with memcpy and compared with memcmp
+typedef struct game_state {
+    // Generator for the game's random events, so a restored game draws what the original would have
+    random_state rng;
+    // The encounter stack and its discard pile
+    encounter_stack encounters;
+
+    int32_t morale;
+    int32_t round_index;
+    int8_t turn_index;
+    bool turn_in_progress;
+    bool used_ability;
+    bool do_encounter;
+
+    int8_t character_count;
+    int8_t num_objectives;
+    bool is_final_mission;
+    int8_t final_mission_type;
+
+    room_id xenomorph_location;
+    // NO_ROOM when Ash isn't in the game
+    room_id ash_location;
+    int8_t ash_health;
+    bool ash_killed;
+    bool jonesy_caught;
+
+    // Index of each objective in objectives_stack, whether it has been completed, and where it is
+    int8_t objectives[NUM_OBJECTIVES];
+    bool objectives_completed[NUM_OBJECTIVES];
+    room_id objective_locations[NUM_OBJECTIVES];
+
+    character_snapshot characters[5];
+
+    // Number of rooms in the map the state belongs to, and the state of each of them by room id
+    int32_t room_count;
+    room_snapshot rooms[];
+} game_state;
+
+// First bytes of every save file
+#define SAVE_MAGIC "AFTNSAV"
+// Bumped whenever game_state or the header below changes, saves of other versions are rejected
+#define SAVE_VERSION 2
+// Written in the machine's byte order, saves from machines with another byte order are rejected
+#define SAVE_BYTE_ORDER 0x01020304u
+
+// Header at the start of a save file, followed by the saved game_state
+typedef struct save_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    // Size of the game_state that follows
+    uint64_t state_size;
+
+    // Map the game was played on, saves can only be loaded onto the same map
+    int32_t room_count;
+    char map_name[32];
+    int32_t padding;
+} save_header;
+
+size_t game_state_size(int room_count);
+game_state *new_game_state(const map *game_map);
+game_state *clone_game_state(const game_state *state);
+void copy_game_state(game_state *dest, const game_state *src);
+bool game_states_equal(const game_state *a, const game_state *b);
+uint64_t hash_game_state(const game_state *state);
+
+void capture_game_state(const game_manager *manager, game_state *state);
+void restore_game_state(game_manager *manager, const game_state *state);
+
+bool save_game_state(const game_state *state, const map *game_map, const char *fn, map_error *error);
+game_state *load_game_state(const char *fn, const map *game_map, map_error *error);
+
+#endif
@@ -0,0 +1,90 @@
+/**
+ * @file
+ * @date   16-Oct-2026
+ * @brief The input_provider interface the game pulls decisions from, and the built-in providers
+*/
+
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils.h"
+
+// The kinds of decisions the game asks an input_provider for
+typedef enum {
+    // Pick a character at the start of the game, or e to exit
+    DECISION_PICK_CHARACTER,
+    // Any key to start the game
+    DECISION_START_GAME,
+    // The action menu of the active character
+    DECISION_ACTION,
+    // A room to move a character to
+    DECISION_MOVE,
+    // A yes/no question, answered with y or n
+    DECISION_CONFIRM,
+    // Which of the FLASHLIGHT and ELECTRIC PROD to use against a morale loss
+    DECISION_MORALE_ITEM,
+    // A room to send Ash or the Xenomorph to, or to scan with a MOTION TRACKER
+    DECISION_TARGET_ROOM,
+    // What to pick up, drop, use, or craft
+    DECISION_ITEM,
+    // How much Scrap to pick up, drop, or give
+    DECISION_AMOUNT,
+    // The character to use Ripley's ability on, or to give items to
+    DECISION_CHARACTER
+} DECISION_TYPES;
+
+// Action menu keys that only print information or save and load the game, bots skip these
+#define INFORMATION_ACTIONS "hikvloqrwf"
+
+// Most answers get_bot_choices gives for one decision
+#define MAX_BOT_CHOICES 64
+
+// The game asking for a decision, defined in manager.h
+struct game_manager;
+
+// Something the game can ask for decisions. Each decision lists the keys that are valid answers, and the
+// provider returns one of them. The game asks again if it gets anything else, so interactive providers
+// can pass input through unchecked
+typedef struct input_provider input_provider;
+struct input_provider {
+    // Pick one of the characters in `options`. `manager` is the game asking, which providers may read
+    // but must not change
+    char (*choose)(input_provider *self, struct game_manager *manager, DECISION_TYPES decision, const char *options);
+    // Release the provider
+    void (*free)(input_provider *self);
+};
+
+// Answers from a fixed sequence of keys, then from a fallback provider
+typedef struct scripted_input {
+    input_provider provider;
+
+    // Keys to answer with, in order
+    char *choices;
+    int num_choices;
+    // Index of the next key in `choices`
+    int position;
+
+    // Provider to ask once the script runs out, NULL to end the game instead
+    input_provider *fallback;
+} scripted_input;
+
+// Picks a uniformly random valid answer to every decision, never exiting the game
+typedef struct random_input {
+    input_provider provider;
+
+    // The bot's own generator, so its choices don't change the game's random events
+    random_state rng;
+} random_input;
+
+input_provider *new_terminal_input();
+input_provider *new_scripted_input(const char *choices, input_provider *fallback);
+input_provider *read_input_script(const char *fn, input_provider *fallback);
+input_provider *new_random_input(uint64_t seed, uint64_t stream);
+int get_bot_choices(DECISION_TYPES decision, const char *options, char *candidates);
+
+#endif
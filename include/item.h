@@ -9,6 +9,7 @@
 #define ITEM_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -28,8 +29,14 @@ typedef enum {
 extern int item_costs[NUM_ITEM_TYPES];
 extern char *item_names[NUM_ITEM_TYPES];
 extern char *item_desc[NUM_ITEM_TYPES];
+extern bool item_uses_actions[NUM_ITEM_TYPES];
 extern int item_uses[NUM_ITEM_TYPES];
 
+// Handle of an item in its game's item pool, see get_item
+typedef int32_t item_id;
+// Marks an empty item slot, both for item_id handles and for the item types of an item_snapshot
+#define NO_ITEM -1
+
 // Structure for holding item data
 typedef struct item {
     // Type of item
@@ -40,9 +47,13 @@ typedef struct item {
     int uses;
 } item;
 
-void print_item(item *i);
-void print_item_type(ITEM_TYPES type, int discount);
+void print_item(FILE *out, const item *i);
+void print_item_type(FILE *out, ITEM_TYPES type, int discount);
+
+// The game manager is defined in manager.h
+struct game_manager;
 
-item *new_item(ITEM_TYPES type);
+item_id new_item(struct game_manager *manager, ITEM_TYPES type);
+void free_item(struct game_manager *manager, item_id id);
 
 #endif
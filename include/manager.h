@@ -9,17 +9,60 @@
 #define MANAGER_H
 
 #include <limits.h>
+#include <setjmp.h>
 #include <stdlib.h>
 #include <time.h>
 
 #include "arguments.h"
 #include "character.h"
+#include "input.h"
 #include "map/encounter.h"
 #include "map/map.h"
 #include "map/room.h"
 #include "objective.h"
 #include "utils.h"
 
+// Ways a game can end
+typedef enum {
+    GAME_WON,
+    GAME_LOST_MORALE,
+    GAME_LOST_SELF_DESTRUCT,
+    // A player exited the game
+    GAME_EXITED,
+    // The game reached its round limit
+    GAME_ROUND_LIMIT
+} GAME_RESULTS;
+
+#define NUM_GAME_RESULTS 5
+
+// Whether new_game made a game, and why not if it didn't
+typedef enum {
+    NEW_GAME_CREATED,
+    // A player exited during character selection
+    NEW_GAME_EXITED,
+    // There wasn't enough memory for the game
+    NEW_GAME_OUT_OF_MEMORY
+} NEW_GAME_RESULTS;
+
+// Bytes of a game's memory set aside for allocations that only last one action, like ability outputs
+#define GAME_TURN_SCRATCH_SIZE 1024
+// Most items a game on a map with `room_count` rooms can hold at once, a full room's worth in every room
+// and 3 items and a COOLANT CANISTER for each of the 5 characters
+#define MAX_GAME_ITEMS(room_count) (NUM_ROOM_ITEMS * (room_count) + 5 * 4)
+
+// A flat copy of a game, defined in game_state.h
+struct game_state;
+
+// How and when a game ended, returned by game_loop
+typedef struct game_outcome {
+    // Whether the game was won, or why it was lost or stopped
+    GAME_RESULTS result;
+    // Round the game ended on, from 1
+    int round;
+    // Turn of the round the game ended on, from 0 like turn_index
+    int turn;
+} game_outcome;
+
 // Structure holding all game data
 typedef struct game_manager game_manager;
 struct game_manager {
@@ -35,8 +78,26 @@ struct game_manager {
     // Final mission type - determined upon completing all other objectives
     FINAL_MISSION_TYPES final_mission_type;
 
-    // Pointer to the game's map
+    // The block of memory the manager is at the start of, which every other allocation of the game comes
+    // from. Freeing the manager releases the whole game
+    arena memory;
+    // Part of memory for allocations that only last one action, reset before each action menu
+    arena turn_scratch;
+    // The game's item pool, every item in the game is one of these, referred to by its index
+    item *items;
+    // Handles of the items in the pool that aren't in the game, taken by new_item and returned by free_item
+    item_id *free_items;
+    int num_free_items;
+
+    // Pointer to the game's map, which the game never changes
     map *game_map;
+    // Working memory for this game's searches over game_map
+    search_scratch *scratch;
+    // Scrap, items, and events in each room of game_map, indexed by room id
+    room_state *room_states;
+
+    // The encounter stack and its discard pile
+    encounter_stack encounters;
 
     // Pointer to the xenomorph's current location
     room *xenomorph_location;
@@ -54,16 +115,72 @@ struct game_manager {
     int round_index;
     // Counter of how many of a character's turns have occurred
     int turn_index;
+    // Whether the active character's turn has started, so a restored game resumes it at the action menu
+    bool turn_in_progress;
+    // Whether the active character has used an ability that can only be used once per turn
+    bool used_ability;
+    // Whether an encounter will be drawn at the end of the active character's turn
+    bool do_encounter;
 
     // Number of characters in the game
     int character_count;
+    // This game's copy of every character, the ones in play are pointed to by characters
+    struct character roster[5];
     // Array of characters in the game
     struct character *characters[5];
     // The character that is currently acting
     struct character *active_character;
+
+    // Generator for the game's random events
+    random_state rng;
+
+    // Where the game's decisions come from
+    input_provider *input;
+    // Where the game's text goes, NULL for headless games that print nothing
+    FILE *output;
+    // Save file the w and f action menu keys save to and load from, NULL to turn them off
+    const char *save_file;
+    // Set while the game is recorded to a replay log, which can't hold a loaded game, to turn the f key off
+    bool recording;
+
+    // Number of rounds to play before ending the game with GAME_ROUND_LIMIT, 0 for no limit
+    int max_rounds;
+    // Team morale at the start of each round, indexed from round 1. NULL to not record morale
+    int *morale_history;
+    // Number of rounds morale_history has room for
+    int morale_history_length;
+
+    // How the game ended, set by end_game
+    game_outcome outcome;
+    // Where end_game jumps to when the game ends, set by game_loop
+    jmp_buf *end_of_game;
 };
 
-game_manager *new_game(const arguments args, map *game_map);
+// The state of room `r` in the game managed by `manager`
+static inline room_state *get_room_state(game_manager *manager, const room *r)
+{
+    return &manager->room_states[r->id];
+}
+
+// The item with handle `id` in the game managed by `manager`, NULL for NO_ITEM
+static inline item *get_item(const game_manager *manager, item_id id)
+{
+    return id == NO_ITEM ? NULL : &manager->items[id];
+}
+
+game_manager *new_game(const arguments args,
+                       map *game_map,
+                       random_state rng,
+                       input_provider *input,
+                       FILE *output,
+                       NEW_GAME_RESULTS *result);
+game_manager *new_game_from_state(const struct game_state *state, map *game_map, input_provider *input, FILE *output);
+
+void free_game(game_manager *manager);
+
+void game_print(const game_manager *manager, const char *format, ...);
+char get_choice(game_manager *manager, DECISION_TYPES decision, const char *options);
+char *menu_options(char *options, int num_entries, const char *extra_keys);
 
 void print_game_objectives(game_manager *manager);
 void update_objectives(game_manager *manager);
@@ -71,8 +188,13 @@ void setup_final_mission(game_manager *manager);
 void update_final_mission(game_manager *manager);
 
 void win_game(game_manager *manager);
+void end_game(game_manager *manager, GAME_RESULTS result);
 
-room *character_move(game_manager *manager, struct character *to_move, room_queue *allowed_moves, bool allow_back);
+room *character_move(game_manager *manager,
+                     struct character *to_move,
+                     room **allowed_moves,
+                     int num_allowed_moves,
+                     bool allow_back);
 bool xeno_move(game_manager *manager, int num_spaces, int morale_drop);
 bool ash_move(game_manager *manager, int num_spaces);
 void check_ash_health(game_manager *manager);
@@ -85,9 +207,9 @@ void flee(game_manager *manager, struct character *moved);
 bool pickup(game_manager *manager);
 bool drop(game_manager *manager);
 int use(game_manager *manager);
+void save_game(game_manager *manager);
+void load_game(game_manager *manager);
 
-room_queue *shortest_path(map *game_map, room *from, room *to);
-
-void game_loop(game_manager *manager);
+game_outcome game_loop(game_manager *manager);
 
 #endif
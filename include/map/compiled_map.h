@@ -0,0 +1,89 @@
+/**
+ * @file
+ * @date   16-Oct-2026
+ * @brief The binary compiled map format and accompanying function headers
+*/
+
+#ifndef COMPILED_MAP_H
+#define COMPILED_MAP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "map/map.h"
+
+// First bytes of every compiled map image
+#define COMPILED_MAP_MAGIC "AFTNMAP"
+// Bumped whenever the layout below changes, images of other versions are rejected
+#define COMPILED_MAP_VERSION 1
+// Written in the machine's byte order, images from machines with another byte order are rejected
+#define COMPILED_MAP_BYTE_ORDER 0x01020304u
+// Every section starts on a multiple of this many bytes so it can be used in place
+#define COMPILED_MAP_ALIGNMENT 8
+
+// Location of an array in a compiled map image, size 0 for arrays the map doesn't have
+typedef struct compiled_map_section {
+    uint64_t offset;
+    uint64_t size;
+} compiled_map_section;
+
+// The fixed part of a room, the rest of a room is game state set up by the game manager
+typedef struct compiled_room {
+    char name[32];
+    // Id of the room at the other end of this room's ladder, NO_ROOM if it has none
+    uint16_t ladder_connection;
+    uint8_t is_corridor;
+    uint8_t padding;
+} compiled_room;
+
+// Header at the start of a compiled map image, followed by the sections it points to
+typedef struct compiled_map_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    // Size of the whole image in bytes
+    uint64_t image_size;
+
+    char name[32];
+
+    int32_t room_count;
+    int32_t named_room_count;
+    int32_t scrap_room_count;
+    int32_t event_room_count;
+    int32_t coolant_room_count;
+    int32_t room_index_capacity;
+
+    uint16_t player_start_room;
+    uint16_t xenomorph_start_room;
+    uint16_t ash_start_room;
+    uint16_t padding;
+
+    // compiled_room[room_count]
+    compiled_map_section rooms;
+    // int32_t[room_count + 1] and room_id[adjacency_offsets[room_count]], see map.h
+    compiled_map_section adjacency_offsets;
+    compiled_map_section adjacency;
+    // int32_t[named_room_count]
+    compiled_map_section named_room_indices;
+    // room_id[] for each list of special rooms
+    compiled_map_section scrap_rooms;
+    compiled_map_section event_rooms;
+    compiled_map_section coolant_rooms;
+    // room_id[room_index_capacity]
+    compiled_map_section room_index;
+    // NUL-terminated text
+    compiled_map_section ascii_map;
+    // unsigned char[room_count * room_count], empty for maps too large for path tables
+    compiled_map_section distances;
+    compiled_map_section next_hop;
+    // room_set[room_count * (MAX_RING_DISTANCE + 1)], empty for maps too large for distance rings
+    compiled_map_section rooms_at_distance;
+    compiled_map_section rooms_within_distance;
+} compiled_map_header;
+
+bool is_compiled_map(FILE *fp);
+bool write_compiled_map(const map *game_map, const char *fn, map_error *error);
+map *load_compiled_map(const char *fn, map_error *error);
+void free_compiled_map(map *game_map);
+
+#endif
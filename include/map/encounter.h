@@ -9,8 +9,11 @@
 #define ENCOUNTER_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 
+#include "utils.h"
+
 // Enum of different types of encounter
 typedef enum {
     QUIET,
@@ -24,21 +27,71 @@ typedef enum {
 
 extern char *encounter_names[7];
 
+#define NUM_ENCOUNTER_TYPES 7
+
 // The number of encounters in the encounter stack
 #define ENCOUNTER_STACK_SIZE 21
 
-extern int num_encounters;
-extern ENCOUNTER_TYPES encounters[ENCOUNTER_STACK_SIZE];
-extern ENCOUNTER_TYPES discard_encounters[ENCOUNTER_STACK_SIZE];
+extern const ENCOUNTER_TYPES encounter_deck[ENCOUNTER_STACK_SIZE];
+
+// The number of alien and ORDER 937 cards in the encounter deck, the rest are QUIET
+#define NUM_ALIEN_ENCOUNTERS 6
+#define NUM_ORDER937_ENCOUNTERS 4
+// The number of QUIET cards in the encounter deck, no other type has as many cards
+#define NUM_QUIET_ENCOUNTERS (ENCOUNTER_STACK_SIZE - NUM_ALIEN_ENCOUNTERS - NUM_ORDER937_ENCOUNTERS)
+
+// A game's encounter stack and its discard pile. The discard pile is only ever searched by type, so it is
+// kept as a count of each type rather than in order
+typedef struct encounter_stack {
+    // The number of cards left in the stack
+    int8_t num_encounters;
+    // Cards in the stack, the top card is at num_encounters - 1
+    int8_t encounters[ENCOUNTER_STACK_SIZE];
+    // The number of cards of each type left in the stack
+    int8_t remaining[NUM_ENCOUNTER_TYPES];
+    // The number of cards of each type in the discard pile
+    int8_t discarded[NUM_ENCOUNTER_TYPES];
+} encounter_stack;
+
+void reset_encounters(encounter_stack *stack);
+void shuffle_encounters(encounter_stack *stack, random_state *rng);
+
+ENCOUNTER_TYPES draw_encounter(encounter_stack *stack, random_state *rng);
+void return_encounter(encounter_stack *stack, ENCOUNTER_TYPES encounter);
+double encounter_probability(const encounter_stack *stack, ENCOUNTER_TYPES encounter);
+
+// Most draws get_encounter_odds gives the chances of
+#define ENCOUNTER_ODDS_MAX_DRAWS 3
+// Number of mixes of ENCOUNTER_ODDS_MAX_DRAWS cards among the encounter types, 9 choose 3
+#define ENCOUNTER_MAX_MIXES 84
+// Number of makeups a stack can have, the product over types of one more than their cards in encounter_deck
+#define NUM_ENCOUNTER_MAKEUPS 3456
+
+// How many cards of each type are among some draws, in any order
+typedef struct encounter_mix {
+    int8_t counts[NUM_ENCOUNTER_TYPES];
+} encounter_mix;
 
-void shuffle_encounters();
+// Chance of each mix of cards among the next draws from an encounter stack, from the cards left in it
+typedef struct encounter_odds {
+    // Number of cards drawn, at most the number left in the stack and ENCOUNTER_ODDS_MAX_DRAWS
+    int draws;
+    // mixes[i] is the chance that the cards drawn are the i-th mix of encounter_mixes, in any order
+    int num_mixes;
+    double mixes[ENCOUNTER_MAX_MIXES];
+    // chance[a][o] is the chance that exactly a alien and o ORDER 937 cards are drawn, the rest being QUIET
+    double chance[ENCOUNTER_ODDS_MAX_DRAWS + 1][ENCOUNTER_ODDS_MAX_DRAWS + 1];
+    // by_type[t][c] is the chance that exactly c cards of type t are drawn, whatever the other cards are
+    double by_type[NUM_ENCOUNTER_TYPES][ENCOUNTER_ODDS_MAX_DRAWS + 1];
+} encounter_odds;
 
-int draw_encounter();
-int discard_encounter();
-void replace_all_encounters();
-void replace_encounter();
+const encounter_mix *encounter_mixes(int draws, int *num_mixes);
+const encounter_odds *get_encounter_odds(const encounter_stack *stack, int draws);
+double alien_encounter_chance(const encounter_stack *stack, int draws);
+double encounter_type_chance(const encounter_stack *stack, ENCOUNTER_TYPES encounter, int draws);
 
-void replace_alien_cards();
-void replace_order937_cards();
+void replace_all_encounters(encounter_stack *stack, random_state *rng);
+void replace_alien_cards(encounter_stack *stack, random_state *rng);
+void replace_order937_cards(encounter_stack *stack, random_state *rng);
 
 #endif
@@ -10,6 +10,7 @@
 
 #include <limits.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -17,6 +18,33 @@
 #include "map/room.h"
 #include "utils.h"
 
+// A set of rooms from a map of at most 64 rooms, bit i is set when room i is in the set
+typedef uint64_t room_set;
+
+// Largest distance with precomputed room sets, 3 spaces for fleeing and moving Ash or the xenomorph
+#define MAX_RING_DISTANCE 3
+
+static inline bool room_set_contains(room_set set, int id)
+{
+    return (set >> id) & 1;
+}
+
+static inline room_set room_set_add(room_set set, int id)
+{
+    return set | ((room_set)1 << id);
+}
+
+static inline int room_set_count(room_set set)
+{
+    return __builtin_popcountll(set);
+}
+
+// Index of the lowest room in a non-empty set
+static inline int room_set_first(room_set set)
+{
+    return __builtin_ctzll(set);
+}
+
 // A structure to store rooms and corridors, along with auxiliary data representations
 typedef struct map {
     // This map's name
@@ -24,13 +52,25 @@ typedef struct map {
 
     // The number of rooms in this map
     int room_count;
+    // The number of rooms `rooms` has space for
+    int room_capacity;
     // An array of pointers to the rooms in this map
-    room *rooms[64];
+    room **rooms;
+    // For compiled maps, the single allocation holding every room. NULL for text maps, whose rooms
+    // are allocated one at a time
+    room *room_block;
 
     // The number of named rooms (not corridors) in this map
     int named_room_count;
+    // The number of indices `named_room_indices` has space for
+    int named_room_capacity;
     // The indices of named rooms in `rooms`
-    int named_room_indices[64];
+    int *named_room_indices;
+
+    // Open addressing hash index over room names, filled in as rooms are read. Holds
+    // room_index_capacity slots, a power of two, each either a room id or NO_ROOM
+    int room_index_capacity;
+    room_id *room_index;
 
     // The room playable characters are intended to start in
     room *player_start_room;
@@ -41,29 +81,139 @@ typedef struct map {
 
     // The number of rooms that start with scrap
     int scrap_room_count;
+    int scrap_room_capacity;
     // Pointers to the rooms that start with scrap
-    room *scrap_rooms[8];
+    room **scrap_rooms;
     // The number of rooms that start with events
     int event_room_count;
+    int event_room_capacity;
     // Pointers to the rooms that start with events
-    room *event_rooms[8];
+    room **event_rooms;
     // The number of rooms that start with coolant
     int coolant_room_count;
-    // Pointers to the rooms that start with events
-    room *coolant_rooms[8];
+    int coolant_room_capacity;
+    // Pointers to the rooms that start with coolant
+    room **coolant_rooms;
+
+    // Rooms referred to by name in the game rules, looked up once when the map is read.
+    // NULL if the map doesn't have a room with that name
+    room *docking_bay;
+    room *airlock;
+    room *bridge;
+    room *equipment_storage;
+    room *mu_th_ur;
 
     // An ascii representation of the map (optional)
     char *ascii_map;
+
+    // Compressed sparse row adjacency built by read_map. The rooms connected to room i are
+    // adjacency[adjacency_offsets[i]] up to adjacency[adjacency_offsets[i + 1] - 1], with the
+    // room's ladder connection, if any, stored as the last entry of its row
+    int *adjacency_offsets;
+    room_id *adjacency;
+
+    // Rooms exactly / at most k edges from each room for k in [0, MAX_RING_DISTANCE], indexed by
+    // [id * (MAX_RING_DISTANCE + 1) + k]. Only built for maps of at most 64 rooms, NULL otherwise
+    room_set *rooms_at_distance;
+    room_set *rooms_within_distance;
+
+    // Shortest path tables computed once by read_map, indexed by [from * room_count + to]. These take
+    // room_count^2 bytes, so they are only built for maps of at most MAX_PATH_TABLE_ROOMS rooms, NULL otherwise
+    // The number of edges between two rooms, UNREACHABLE_DISTANCE if there is no path
+    unsigned char *distances;
+    // The index of the first room on a shortest path between two rooms
+    unsigned char *next_hop;
+
+    // For compiled maps, the memory-mapped image the tables above point into. NULL for text maps
+    void *image;
+    size_t image_size;
 } map;
 
-room *get_room(map *game_map, const char *room_name);
-int get_room_index(map *game_map, const char *room_name);
+// Marks a pair of rooms with no path between them in `distances`
+#define UNREACHABLE_DISTANCE UCHAR_MAX
+// Largest map with shortest path tables, room indices and distances must fit in an unsigned char
+#define MAX_PATH_TABLE_ROOMS UCHAR_MAX
+
+// Why a map couldn't be read
+typedef struct map_error {
+    // 1-based line and column of the problem in the map file, 0 if it isn't tied to a line or column
+    int line;
+    int column;
+    char message[256];
+} map_error;
+
+// Connections collected while reading a map file, compressed into adjacency once every room is known
+typedef struct connection_list {
+    int count;
+    int capacity;
+    room_id *from;
+    room_id *to;
+} connection_list;
+
+// Caller-owned working memory for graph searches, indexed by room id. Searches never write to the map,
+// so any number of them can run over one map as long as each has its own scratch space
+typedef struct search_scratch {
+    // Number of rooms each array can index
+    int capacity;
+
+    // Stamp of the current search, a room has been reached when visited[id] == epoch
+    unsigned int epoch;
+    unsigned int *visited;
+    // Number of edges from the search's start to each reached room
+    int *distance;
+    // For multi-source searches, the start room each reached room was found from
+    int *origin;
+    // The room each reached room was found from
+    int *previous;
+    // BFS frontier
+    room_queue *frontier;
+    // Target flags for find_nearest_room, cleared by clear_targets
+    bool *targets;
+
+    // Rooms matched by the last find_rooms_by_distance call
+    int result_count;
+    room **results;
+} search_scratch;
+
+unsigned int hash_room_name(const char *room_name);
+void index_room(map *game_map, room *r);
+room *get_room(const map *game_map, const char *room_name);
+int get_room_index(const map *game_map, const char *room_name);
 room *add_room_if_not_exists(map *game_map, char *room_name);
 
-void reset_search(map *game_map, int distance);
-room_queue *find_rooms_by_distance(map *game_map, room *start_room, int distance, bool inclusive);
+size_t search_scratch_size(const map *game_map);
+search_scratch *alloc_search_scratch(const map *game_map, arena *memory);
+search_scratch *new_search_scratch(const map *game_map);
+void free_search_scratch(search_scratch *scratch);
+void begin_search(search_scratch *scratch);
+bool *clear_targets(search_scratch *scratch);
+int find_rooms_by_distance(const map *game_map,
+                           const room *start_room,
+                           int distance,
+                           bool inclusive,
+                           search_scratch *scratch);
+
+void add_connection(connection_list *connections, room *a, room *b);
+void build_adjacency(map *game_map, const connection_list *connections);
+int room_connection_count(const map *game_map, const room *r);
+room *room_connection(const map *game_map, const room *r, int i);
+
+void build_path_tables(map *game_map);
+void build_distance_rings(map *game_map);
+room_set rooms_by_distance(const map *game_map, const room *start_room, int distance, bool inclusive);
+int room_distance(const map *game_map, const room *from, const room *to, search_scratch *scratch);
+room *next_room_towards(const map *game_map, const room *from, const room *to, search_scratch *scratch);
+room *find_nearest_room(const map *game_map,
+                        const room *source,
+                        const bool *targets,
+                        search_scratch *scratch,
+                        int *distance,
+                        room **first_step);
 
-map *read_map(const char *fn);
-void print_map(const map *game_map);
+bool map_error_at(map_error *error, int line, int column, const char *format, ...);
+void print_map_error(const char *fn, const map_error *error);
+map *read_map(const char *fn, map_error *error);
+void print_map(FILE *out, const map *game_map);
+void free_map(map *game_map);
 
 #endif
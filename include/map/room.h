@@ -9,22 +9,40 @@
 #define ROOM_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "item.h"
 
+// Index of a room in its map's `rooms` array, used wherever maps store connections
+typedef uint16_t room_id;
+// A room_id that refers to no room
+#define NO_ROOM UINT16_MAX
+
+// Size of a room name, including the terminating NUL
+#define ROOM_NAME_LENGTH 32
+
 // Structure containing general room data
 #define NUM_ROOM_ITEMS 6
 typedef struct room room;
 struct room { // This forward declaration allows for a room pointer in the struct definition
     // Room name
-    char name[32];
+    char name[ROOM_NAME_LENGTH];
+    // Index of this room in its map's `rooms` array
+    int id;
 
     // Whether the room is a corridor or not
     bool is_corridor;
 
+    // A connection by ladder, other connections are stored in the map's adjacency arrays
+    room *ladder_connection;
+};
+
+// The parts of a room that change during a game. Each game keeps its own, indexed by room id, so the
+// rooms themselves never change once the map is read and any number of games can share a map
+typedef struct room_state {
     // The number of scrap in this room
     int num_scrap;
 
@@ -33,28 +51,19 @@ struct room { // This forward declaration allows for a room pointer in the struc
 
     // Number of items in the room
     int num_items;
-    // Array of pointers to items in the room
-    item *room_items[NUM_ROOM_ITEMS];
-
-    // Number of connections to other rooms
-    int connection_count;
-    // Array of connections to other rooms
-    room *connections[8];
-    // A connection by ladder
-    room *ladder_connection;
+    // Handles of the items in the room, NO_ITEM for empty slots
+    item_id room_items[NUM_ROOM_ITEMS];
+} room_state;
 
-    // Data used when searching over a map
-    int search_distance;
-    bool search_discovered;
-    room *search_previous_room;
-
-    // Room pointer used to build linked list of rooms for room queue
-    room *room_queue_next;
-};
+struct map;
 
-room *create_room(char name[32], bool is_corridor);
-void add_connection(room *a, room *b);
+room *create_room(char name[ROOM_NAME_LENGTH], bool is_corridor);
 
-void print_room(room *r, bool prepend_tab);
+void print_room(FILE *out,
+                const struct map *game_map,
+                room *r,
+                const room_state *state,
+                const item *items,
+                bool prepend_tab);
 
 #endif
@@ -0,0 +1,76 @@
+/**
+ * @file
+ * @date   16-Oct-2026
+ * @brief A Monte Carlo Tree Search input provider that plays characters for the crew, and accompanying
+ *        function headers
+*/
+
+#ifndef MCTS_H
+#define MCTS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "game_state.h"
+#include "input.h"
+#include "manager.h"
+#include "map/map.h"
+#include "utils.h"
+
+// Most keys the search looks ahead by, counting the keys already picked since the last action menu
+#define MCTS_MAX_DEPTH 128
+// Rollouts per decision when neither budget is limited
+#define MCTS_DEFAULT_ITERATIONS 2000
+
+// How the crew AI searches
+typedef struct mcts_settings {
+    // Rollouts per decision, 0 for no limit
+    int iterations;
+    // Milliseconds per decision, 0 for no limit
+    int time_limit;
+    // Number of threads to search on
+    int threads;
+    // Number of round ends a rollout plays through before its game is scored
+    int horizon;
+    // Seed for the AI's own random choices
+    uint64_t seed;
+} mcts_settings;
+
+// One search thread, defined in mcts.c
+struct mcts_worker;
+
+// Plays the characters in the last turns of every round by searching the game's future. Every decision
+// in those turns replays the game from the last action menu of the turn, so the AI never needs anything
+// but the game_state of that menu and the keys it has picked since
+typedef struct mcts_input {
+    input_provider provider;
+
+    mcts_settings settings;
+    // Turns from this index on are played by the AI, other decisions go to `fallback`
+    int first_turn;
+    input_provider *fallback;
+
+    // State of the game at the last action menu the AI answered, NULL until the first one
+    game_state *root;
+    // Round and turn `root` was captured on
+    int root_round;
+    int root_turn;
+    // Keys the AI picked since `root` was captured
+    char prefix[MCTS_MAX_DEPTH];
+    int prefix_length;
+
+    // Search threads, created with the first search
+    struct mcts_worker *workers;
+    // Set if there wasn't enough memory for the search threads' games, `fallback` answers every decision then
+    bool out_of_memory;
+
+    // Totals over every search, for benchmarking
+    long decisions;
+    long rollouts;
+    double search_seconds;
+} mcts_input;
+
+input_provider *new_mcts_input(mcts_settings settings, int first_turn, input_provider *fallback);
+void print_mcts_statistics(FILE *out, const mcts_input *ai);
+
+#endif
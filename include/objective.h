@@ -13,6 +13,7 @@
 
 #include "item.h"
 #include "map/room.h"
+#include "utils.h"
 
 // An enum defining types of objectives
 typedef enum { BRING_ITEM_TO_LOCATION, CREW_AT_LOCATION_WITH_MINIMUM_SCRAP, DROP_COOLANT } OBJECTIVE_TYPES;
@@ -55,12 +56,12 @@ extern char *final_mission_names[NUM_FINAL_MISSIONS];
 extern char *final_mission_desc[NUM_FINAL_MISSIONS];
 
 #define NUM_OBJECTIVES 10
-extern objective objectives_stack[NUM_OBJECTIVES];
+extern const objective objectives_stack[NUM_OBJECTIVES];
 
-objective *get_objectives(int n);
+void get_objectives(objective *out, int n, random_state *rng);
 
-void complete_objective(objective *o);
+void complete_objective(FILE *out, objective *o);
 
-void print_objective_description(objective o);
+void print_objective_description(FILE *out, objective o);
 
 #endif
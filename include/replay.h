@@ -0,0 +1,95 @@
+/**
+ * @file
+ * @date   16-Oct-2026
+ * @brief The binary replay log format, the input provider that records it, and accompanying function headers
+*/
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "arguments.h"
+#include "input.h"
+#include "manager.h"
+#include "map/map.h"
+
+// First bytes of every replay log
+#define REPLAY_MAGIC "AFTNRPL"
+// First bytes of the trailer of a log whose game finished
+#define REPLAY_END_MAGIC "AFTNEND"
+// Bumped whenever the layout below changes, logs of other versions are rejected
+#define REPLAY_VERSION 3
+// Written in the machine's byte order, logs from machines with another byte order are rejected
+#define REPLAY_BYTE_ORDER 0x01020304u
+
+// Header at the start of a replay log: everything new_game needs besides the decisions. It is followed
+// by every key the game's input provider answered with, one byte each, then a replay_trailer if the game
+// finished. Logs of games that were killed still replay up to their last decision
+typedef struct replay_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+
+    uint64_t seed;
+    int32_t n_players;
+    int32_t n_characters;
+    uint8_t use_ash;
+    uint8_t padding[3];
+
+    // Map the game was played on, checked against the map at game_file when replaying
+    int32_t room_count;
+    char map_name[32];
+    char game_file[256];
+} replay_header;
+
+// End of a replay log, recording how the game ended
+typedef struct replay_trailer {
+    char magic[8];
+    int32_t result;
+    int32_t round;
+    int32_t turn;
+    int32_t padding;
+    // Number of keys between the header and the trailer
+    uint64_t decisions;
+    // hash_game_state of the game when it ended
+    uint64_t state_hash;
+} replay_trailer;
+
+// Passes every decision to another provider, appending each answer to a replay log
+typedef struct recording_input {
+    input_provider provider;
+
+    input_provider *inner;
+    FILE *log;
+    // Number of keys written
+    uint64_t decisions;
+} recording_input;
+
+// What a replay found
+typedef struct replay_summary {
+    // Number of keys in the log, and how many the replayed game used
+    long decisions;
+    long decisions_used;
+    // Whether the log has a trailer to check the replay against
+    bool complete;
+    // The outcome of the replayed game, and for complete logs, the recorded one
+    game_outcome replayed;
+    game_outcome recorded;
+    // For complete logs, whether the replayed game used every key and ended exactly as recorded
+    bool matches;
+} replay_summary;
+
+input_provider *new_recording_input(const char *fn,
+                                    const arguments *args,
+                                    const map *game_map,
+                                    input_provider *inner,
+                                    map_error *error);
+void finish_recording(input_provider *recorder, const game_manager *manager, game_outcome outcome);
+
+bool replay_game(const char *fn, replay_summary *summary, map_error *error);
+void print_replay_summary(FILE *out, const replay_summary *summary);
+
+#endif
@@ -0,0 +1,60 @@
+/**
+ * @file
+ * @date   16-Oct-2026
+ * @brief Batches of bot-played games for aftn-sim, and the structure holding their results
+*/
+
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "arguments.h"
+#include "manager.h"
+#include "map/map.h"
+#include "objective.h"
+
+// Number of rounds that morale is recorded for
+#define SIMULATION_MORALE_ROUNDS 64
+
+// Totals over a batch of simulated games. Every field is a sum over games, so results of parts of a batch
+// add up to the same totals no matter how the batch was split
+typedef struct simulation_results {
+    long games;
+    // Number of games that ended each way, indexed by GAME_RESULTS
+    long results[NUM_GAME_RESULTS];
+    // Sum of the number of rounds each game lasted
+    long total_rounds;
+
+    // Number of games that reached each final mission, and how many of those were won
+    long final_missions[NUM_FINAL_MISSIONS];
+    long final_mission_wins[NUM_FINAL_MISSIONS];
+
+    // Number of games that started each round, and the sum of their morale at its start
+    long morale_games[SIMULATION_MORALE_ROUNDS];
+    long morale_totals[SIMULATION_MORALE_ROUNDS];
+
+    // Number of games that couldn't be played because there wasn't enough memory for them, not counted in games
+    long out_of_memory;
+} simulation_results;
+
+// A flat copy of a game, defined in game_state.h
+struct game_state;
+
+void simulate_game(const sim_arguments *args,
+                   map *game_map,
+                   const struct game_state *start,
+                   long game_index,
+                   simulation_results *results);
+void simulate_games(const sim_arguments *args,
+                    map *game_map,
+                    const struct game_state *start,
+                    long first_game,
+                    long last_game,
+                    simulation_results *results);
+void add_simulation_results(simulation_results *total, const simulation_results *part);
+bool run_simulation(const sim_arguments *args, simulation_results *results, map_error *error);
+void print_simulation_results(FILE *out, const sim_arguments *args, const simulation_results *results);
+
+#endif
@@ -0,0 +1,30 @@
+/**
+ * @file
+ * @date   16-Oct-2026
+ * @brief Win-rate sweeps of aftn-sim over every crew, with and without Ash, on every map in a directory, and
+ *        accompanying function headers
+*/
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "arguments.h"
+#include "map/map.h"
+#include "simulation.h"
+
+// z-score of the two-sided 95% confidence intervals a sweep reports
+#define SWEEP_Z 1.96
+// Number of games a configuration starts with, before anything is known about its win rate
+#define SWEEP_FIRST_BATCH 1000
+
+// Number of crews a sweep plays on each map with and without Ash, every non-empty subset of the 5 characters
+#define SWEEP_CREWS 31
+
+void wilson_interval(long wins, long games, double *low, double *high);
+void sweep_configuration(const sim_arguments *args, map *game_map, simulation_results *results);
+bool run_sweep(const sim_arguments *args, FILE *out, map_error *error);
+
+#endif
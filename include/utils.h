@@ -2,13 +2,14 @@
  * @file
  * @author Charles Averill
  * @date   11-May-2022
- * @brief String and integer util function headers, and the room_queue structure
+ * @brief String and integer util function headers, and the room_queue and arena structures
 */
 
 #ifndef UTILS_H
 #define UTILS_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -17,7 +18,17 @@
 
 #include "map/room.h"
 
-int randint(int low, int high);
+// State of a PCG32 random number generator. Each game owns one, so games never share random numbers
+typedef struct random_state {
+    uint64_t state;
+    // Selects which of 2^63 independent streams the generator produces, always odd
+    uint64_t increment;
+} random_state;
+
+void seed_random(random_state *rng, uint64_t seed, uint64_t stream);
+uint32_t random_next(random_state *rng);
+uint32_t random_below(random_state *rng, uint32_t bound);
+int randint(random_state *rng, int low, int high);
 
 void strip_string(char *str, int len);
 void trim_string(char *str, int size);
@@ -30,15 +41,23 @@ int min(int a, int b);
 
 char get_character();
 
-// Used for Xeno and Ash trajectory planning
+// Fixed-capacity ring buffer of rooms from one map, used as the frontier of map searches. A room may
+// only be queued once at a time, and its id must be less than the queue's capacity
 typedef struct room_queue {
     int size;
     int max_size;
-    room *head;
-    room *tail;
+    // Position of the first room in `rooms`
+    int head;
+    // Ring storage for max_size rooms
+    room **rooms;
+    // Bit `id` is set while the room with that id is queued
+    uint64_t *members;
 } room_queue;
 
+size_t room_queue_size(int capacity);
 room_queue *new_room_queue(int capacity);
+room_queue *init_room_queue(void *memory, int capacity);
+void clear_queue(room_queue *q);
 void print_queue(room_queue *q);
 int push(room_queue *q, room *node);
 room *pop(room_queue *q);
@@ -46,4 +65,22 @@ room *pop_tail(room_queue *q);
 room *poll_position(room_queue *q, int i);
 bool queue_contains(room_queue *q, room *target);
 
+// Alignment of every arena allocation, enough for any type
+#define ARENA_ALIGNMENT 16
+// Bytes an allocation of `size` takes up in an arena
+#define ARENA_SIZE(size) (((size) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1))
+
+// Bump allocator over a block of memory owned by someone else. Allocations are never freed one by one,
+// the arena is reset to an earlier point instead, releasing everything allocated after it
+typedef struct arena {
+    char *memory;
+    size_t capacity;
+    // Bytes allocated so far, a mark that reset_arena can return to
+    size_t used;
+} arena;
+
+void init_arena(arena *a, void *memory, size_t capacity);
+void *arena_alloc(arena *a, size_t size);
+void reset_arena(arena *a, size_t mark);
+
 #endif
@@ -0,0 +1,314 @@
+/**
+ * @file
+ * @date   16-Oct-2026
+ * @brief Logic for listing the legal actions of the active character without asking for input
+*/
+
+#include "action.h"
+#include "character.h"
+
+/**
+ * Set up an action answered first by `menu_key` in the action menu, with every other field unused
+ */
+void _init_action(game_action *action, ACTION_TYPES type, char menu_key)
+{
+    action->type = type;
+    action->item = -1;
+    action->amount = -1;
+    action->character = -1;
+    action->room = NO_ROOM;
+    action->keys[0] = menu_key;
+    action->keys[1] = '\0';
+}
+
+/**
+ * Append a new action to a list, see _init_action
+ * @return          Pointer to the new action
+ */
+game_action *_add_action(game_action *actions, int *num_actions, ACTION_TYPES type, char menu_key)
+{
+    game_action *action = &actions[(*num_actions)++];
+    _init_action(action, type, menu_key);
+
+    return action;
+}
+
+/**
+ * Add a key to the answers of an action
+ */
+void _add_key(game_action *action, char key)
+{
+    int length = strlen(action->keys);
+    action->keys[length] = key;
+    action->keys[length + 1] = '\0';
+}
+
+/**
+ * Add one action for each amount of Scrap a menu offers, 1 up to min(9, max_scrap)
+ */
+void _add_scrap_actions(game_action *actions,
+                        int *num_actions,
+                        const game_action *prototype,
+                        int max_scrap)
+{
+    for (int amount = 1; amount <= min(9, max_scrap); amount++) {
+        game_action *action = &actions[(*num_actions)++];
+        *action = *prototype;
+        action->amount = amount;
+        _add_key(action, '0' + amount);
+    }
+}
+
+/**
+ * Add an action for each destination character_move offers a character in `from`
+ */
+void _add_move_actions(game_action *actions,
+                       int *num_actions,
+                       const game_action *prototype,
+                       const map *game_map,
+                       const room *from)
+{
+    int num_destinations = min(room_connection_count(game_map, from), 9);
+    for (int i = 0; i < num_destinations; i++) {
+        game_action *action = &actions[(*num_actions)++];
+        *action = *prototype;
+        action->room = room_connection(game_map, from, i)->id;
+        _add_key(action, '1' + i);
+    }
+
+    if (from->ladder_connection != NULL) {
+        game_action *action = &actions[(*num_actions)++];
+        *action = *prototype;
+        action->room = from->ladder_connection->id;
+        _add_key(action, 'l');
+    }
+}
+
+/**
+ * Add the actions of the use menu, see use in manager.c
+ */
+void _add_use_actions(game_action *actions,
+                      int *num_actions,
+                      const game_state *state,
+                      const map *game_map,
+                      search_scratch *scratch)
+{
+    const character_snapshot *active = &state->characters[state->turn_index];
+    room *here = game_map->rooms[active->current_room];
+    room *xenomorph = game_map->rooms[state->xenomorph_location];
+
+    int num_usable = 0;
+    for (int i = 0; i < 3; i++) {
+        item_snapshot held = active->held_items[i];
+        if (held.type == NO_ITEM || !item_uses_actions[held.type]) {
+            continue;
+        }
+        char item_key = '1' + num_usable++;
+
+        switch (held.type) {
+        case MOTION_TRACKER:;
+            int num_within_2 = find_rooms_by_distance(game_map, here, 2, true, scratch);
+
+            int num_event_rooms = 0;
+            for (int j = 0; j < num_within_2 && num_event_rooms < 9; j++) {
+                room *nearby = scratch->results[j];
+                if (nearby != here && state->rooms[nearby->id].has_event) {
+                    game_action *action = _add_action(actions, num_actions, ACTION_USE_ITEM, 'u');
+                    action->item = i;
+                    action->room = nearby->id;
+                    _add_key(action, item_key);
+                    _add_key(action, '1' + num_event_rooms++);
+                }
+            }
+            break;
+        case GRAPPLE_GUN:
+            if (room_distance(game_map, xenomorph, here, scratch) <= 3) {
+                int num_alien_locations = min(find_rooms_by_distance(game_map, xenomorph, 3, false, scratch), 9);
+                for (int j = 0; j < num_alien_locations; j++) {
+                    game_action *action = _add_action(actions, num_actions, ACTION_USE_ITEM, 'u');
+                    action->item = i;
+                    action->room = scratch->results[j]->id;
+                    _add_key(action, item_key);
+                    _add_key(action, '1' + j);
+                }
+            }
+            break;
+        case INCINERATOR:
+            if (room_distance(game_map, xenomorph, here, scratch) <= 3) {
+                game_action *action = _add_action(actions, num_actions, ACTION_USE_ITEM, 'u');
+                action->item = i;
+                _add_key(action, item_key);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+/**
+ * Add the actions of the give menu, see the g case of the action menu in manager.c
+ */
+void _add_give_actions(game_action *actions, int *num_actions, const game_state *state)
+{
+    const character_snapshot *active = &state->characters[state->turn_index];
+
+    int num_tradeable = 0;
+    for (int m = 0; m < state->character_count; m++) {
+        const character_snapshot *target = &state->characters[m];
+        if (m == state->turn_index || target->current_room != active->current_room ||
+            !((active->num_items > 0 && target->num_items < 3) ||
+              (active->coolant.type != NO_ITEM && target->coolant.type == NO_ITEM) || active->num_scrap > 0)) {
+            continue;
+        }
+        char character_key = '1' + num_tradeable++;
+
+        if (target->num_items < 3) {
+            int num_items = 0;
+            for (int k = 0; k < 3; k++) {
+                if (active->held_items[k].type != NO_ITEM) {
+                    game_action *action = _add_action(actions, num_actions, ACTION_GIVE_ITEM, 'g');
+                    action->item = k;
+                    action->character = m;
+                    _add_key(action, character_key);
+                    _add_key(action, '1' + num_items++);
+                }
+            }
+        }
+
+        if (active->coolant.type != NO_ITEM && target->coolant.type == NO_ITEM) {
+            game_action *action = _add_action(actions, num_actions, ACTION_GIVE_COOLANT, 'g');
+            action->character = m;
+            _add_key(action, character_key);
+            _add_key(action, 'c');
+        }
+
+        game_action scrap;
+        _init_action(&scrap, ACTION_GIVE_SCRAP, 'g');
+        scrap.character = m;
+        _add_key(&scrap, character_key);
+        _add_key(&scrap, 's');
+        _add_scrap_actions(actions, num_actions, &scrap, active->num_scrap);
+    }
+}
+
+/**
+ * List every action the active character can take from its action menu, in the order the menus offer
+ * them. Actions that only print information, exiting, and answers that back out of a menu aren't included.
+ * Nothing is allocated or printed, so bots and searches can call this as often as they like
+ * @param  state                  State of a game at the active character's action menu
+ * @param  game_map               Map the game is played on
+ * @param  scratch                Working memory for searches over game_map
+ * @param  actions                Filled with the actions, room for at least MAX_LEGAL_ACTIONS
+ * @return          Number of actions in `actions`
+ */
+int get_legal_actions(const game_state *state, const map *game_map, search_scratch *scratch, game_action *actions)
+{
+    const character_snapshot *active = &state->characters[state->turn_index];
+    const character *rules = &default_characters[(int)active->roster_index];
+    const room_snapshot *here = &state->rooms[active->current_room];
+    room *current_room = game_map->rooms[active->current_room];
+
+    int num_actions = 0;
+    game_action prototype;
+    int position;
+
+    // Move
+    _init_action(&prototype, ACTION_MOVE, 'm');
+    _add_move_actions(actions, &num_actions, &prototype, game_map, current_room);
+
+    // Pick up
+    position = 0;
+    if (here->num_scrap > 0) {
+        _init_action(&prototype, ACTION_PICKUP_SCRAP, 'p');
+        _add_key(&prototype, '1' + position++);
+        _add_scrap_actions(actions, &num_actions, &prototype, here->num_scrap);
+    }
+    for (int k = 0; k < NUM_ROOM_ITEMS; k++) {
+        item_snapshot floor = here->room_items[k];
+        if (floor.type == NO_ITEM) {
+            continue;
+        }
+        char item_key = '1' + position++;
+
+        if (floor.type == COOLANT_CANISTER ? active->coolant.type == NO_ITEM : active->num_items < 3) {
+            game_action *action = _add_action(actions, &num_actions, ACTION_PICKUP_ITEM, 'p');
+            action->item = k;
+            _add_key(action, item_key);
+        }
+    }
+
+    // Drop
+    position = 0;
+    if (active->num_scrap > 0) {
+        _init_action(&prototype, ACTION_DROP_SCRAP, 'd');
+        _add_key(&prototype, '1' + position++);
+        _add_scrap_actions(actions, &num_actions, &prototype, active->num_scrap);
+    }
+    for (int k = 0; k < 3; k++) {
+        if (active->held_items[k].type == NO_ITEM) {
+            continue;
+        }
+        char item_key = '1' + position++;
+
+        if (here->num_items < NUM_ROOM_ITEMS) {
+            game_action *action = _add_action(actions, &num_actions, ACTION_DROP_ITEM, 'd');
+            action->item = k;
+            _add_key(action, item_key);
+        }
+    }
+    if (active->coolant.type != NO_ITEM && here->num_items < NUM_ROOM_ITEMS) {
+        game_action *action = _add_action(actions, &num_actions, ACTION_DROP_COOLANT, 'd');
+        _add_key(action, '1' + position);
+    }
+
+    // Craft
+    if (active->num_scrap > 0 && active->num_items < 3) {
+        int cost_reduction = rules->ability_function == brett_ability ? 1 : 0;
+        int num_craftable = 0;
+        for (int m = 0; m < NUM_ITEM_TYPES; m++) {
+            int cost = item_costs[m];
+            if (cost >= 2) {
+                cost -= cost_reduction;
+            }
+
+            if (cost <= active->num_scrap && m != COOLANT_CANISTER && num_craftable < 9) {
+                game_action *action = _add_action(actions, &num_actions, ACTION_CRAFT, 'c');
+                action->item = m;
+                _add_key(action, '1' + num_craftable++);
+            }
+        }
+    }
+
+    // Use
+    _add_use_actions(actions, &num_actions, state, game_map, scratch);
+
+    // Give
+    _add_give_actions(actions, &num_actions, state);
+
+    // Ability. Dallas and Brett have none that can be used from the menu
+    if (!state->used_ability) {
+        if (rules->ability_function == ripley_ability) {
+            for (int m = 0; m < state->character_count; m++) {
+                _init_action(&prototype, ACTION_ABILITY, 'a');
+                prototype.character = m;
+                _add_key(&prototype, '1' + m);
+                _add_move_actions(
+                    actions, &num_actions, &prototype, game_map, game_map->rooms[state->characters[m].current_room]);
+            }
+        } else if (rules->ability_function == parker_ability || rules->ability_function == lambert_ability) {
+            game_action *action = _add_action(actions, &num_actions, ACTION_ABILITY, 'a');
+            _add_key(action, 'y');
+        }
+    }
+
+    // Discard Scrap to view the next encounter
+    if (state->final_mission_type == BLOW_IT_OUT_INTO_SPACE && active->num_scrap > 0) {
+        game_action *action = _add_action(actions, &num_actions, ACTION_VIEW_ENCOUNTER, 'n');
+        _add_key(action, 'y');
+    }
+
+    _add_action(actions, &num_actions, ACTION_END_TURN, 's');
+
+    return num_actions;
+}
@@ -33,12 +33,116 @@ error_t parse_opt(int key, char *arg, struct argp_state *state)
     case 'd':
         arguments->draw_map = true;
         break;
+    case 'q':
+        arguments->quiet = true;
+        break;
+    case 's':
+        strcpy(arguments->input_script, arg);
+        break;
+    case 'b':
+        arguments->bot = true;
+        break;
+    case SEED_KEY:
+        arguments->seed = strtoull(arg, NULL, 10);
+        break;
+    case AI_KEY:
+        arguments->ai_characters = atoi(arg);
+        if (arguments->ai_characters < 0)
+            argp_error(state, "number of AI characters can't be negative");
+        break;
+    case AI_ITERATIONS_KEY:
+        arguments->ai_iterations = atoi(arg);
+        if (arguments->ai_iterations < 0)
+            argp_error(state, "number of AI rollouts can't be negative");
+        break;
+    case AI_TIME_KEY:
+        arguments->ai_time = atoi(arg);
+        if (arguments->ai_time < 0)
+            argp_error(state, "AI search time can't be negative");
+        break;
+    case AI_THREADS_KEY:
+        arguments->ai_threads = atoi(arg);
+        if (arguments->ai_threads < 1)
+            argp_error(state, "AI must use at least 1 thread");
+        break;
+    case RECORD_KEY:
+        strcpy(arguments->record_file, arg);
+        break;
+    case REPLAY_KEY:
+        strcpy(arguments->replay_file, arg);
+        break;
+    case SAVE_KEY:
+        strcpy(arguments->save_file, arg);
+        break;
+    case LOAD_KEY:
+        strcpy(arguments->load_file, arg);
+        break;
+    case COMPILE_MAP_KEY:
+        arguments->compile_map = true;
+        strcpy(arguments->compile_map_input, arg);
+        break;
     case ARGP_KEY_ARG:
-        // Too many arguments, if your program expects only one argument.
-        if (state->arg_num > 0)
+        // The only positional argument is the output of --compile-map
+        if (state->arg_num > 0 || !arguments->compile_map)
             argp_usage(state);
+        strcpy(arguments->compile_map_output, arg);
         break;
     case ARGP_KEY_END:
+        if (arguments->compile_map && state->arg_num == 0)
+            argp_error(state, "--compile-map needs an output file");
+        break;
+    default:
+        return ARGP_ERR_UNKNOWN;
+    }
+
+    return 0;
+}
+
+/**
+ * argp function to parse aftn-sim's options
+ */
+error_t parse_sim_opt(int key, char *arg, struct argp_state *state)
+{
+    struct sim_arguments *arguments = state->input;
+
+    switch (key) {
+    case 'n':
+        arguments->games = atol(arg);
+        if (arguments->games < 1)
+            argp_error(state, "must play at least 1 game");
+        break;
+    case 'j':
+        arguments->threads = atoi(arg);
+        if (arguments->threads < 1)
+            argp_error(state, "must use at least 1 thread");
+        break;
+    case 'c':
+        arguments->game.n_characters = atoi(arg);
+        if (arguments->game.n_characters < 1 || arguments->game.n_characters > 5)
+            argp_error(state, "number of characters must be in [1, 5]");
+        break;
+    case 'a':
+        arguments->game.use_ash = true;
+        break;
+    case 'g':
+        strcpy(arguments->game.game_file, arg);
+        break;
+    case 'r':
+        arguments->max_rounds = atoi(arg);
+        break;
+    case SEED_KEY:
+        arguments->game.seed = strtoull(arg, NULL, 10);
+        break;
+    case LOAD_KEY:
+        strcpy(arguments->game.load_file, arg);
+        break;
+    case SWEEP_KEY:
+        strcpy(arguments->sweep_dir, arg);
+        break;
+    case MARGIN_KEY:
+        arguments->margin = atof(arg);
+        if (arguments->margin <= 0 || arguments->margin >= 1)
+            argp_error(state, "margin must be in (0, 1)");
         break;
     default:
         return ARGP_ERR_UNKNOWN;
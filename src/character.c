@@ -6,8 +6,10 @@
 */
 
 #include "character.h"
+#include "manager.h"
 
-character characters[5] = {
+// Every character as they start a game
+const character default_characters[5] = {
     {"Ripley",
      "Ellen",
      "Warrant Officer",
@@ -16,12 +18,12 @@ character characters[5] = {
      0,
      0,
      0,
-     {0, 0, 0},
-     0,
+     {NO_ITEM, NO_ITEM, NO_ITEM},
+     NO_ITEM,
      0,
      "Spend an action: Move another crewmember 1 SPACE",
      ripley_ability},
-    {"Dallas", "Arthur", "Captain", 5, 0, 0, 0, 0, {0, 0, 0}, 0, 0, "None", dallas_ability},
+    {"Dallas", "Arthur", "Captain", 5, 0, 0, 0, 0, {NO_ITEM, NO_ITEM, NO_ITEM}, NO_ITEM, 0, "None", dallas_ability},
     {"Parker",
      "Dennis",
      "Chief Engineer",
@@ -30,8 +32,8 @@ character characters[5] = {
      0,
      0,
      0,
-     {0, 0, 0},
-     0,
+     {NO_ITEM, NO_ITEM, NO_ITEM},
+     NO_ITEM,
      0,
      "Spend an action: Add 1 Scrap to your inventory from the Scrap pile. Use only once per turn.",
      parker_ability},
@@ -43,8 +45,8 @@ character characters[5] = {
      0,
      0,
      0,
-     {0, 0, 0},
-     0,
+     {NO_ITEM, NO_ITEM, NO_ITEM},
+     NO_ITEM,
      0,
      "Reduce cost of any item that costs 2 or more Scrap by 1 Scrap. Items don't take an action to "
      "craft.",
@@ -57,8 +59,8 @@ character characters[5] = {
      0,
      0,
      0,
-     {0, 0, 0},
-     0,
+     {NO_ITEM, NO_ITEM, NO_ITEM},
+     NO_ITEM,
      0,
      "Spend an action: Look at the upcoming encounter, you may discard it.",
      lambert_ability},
@@ -66,18 +68,19 @@ character characters[5] = {
 
 /**
  * Check if a character has a certain item
+ * @param  manager         Game manager
  * @param  c               Character to check
  * @param  type            Type of item to check for
  * @return      True if `c` has an item of type `type`, false otherwise
  */
-bool character_has_item(character *c, ITEM_TYPES type)
+bool character_has_item(const game_manager *manager, const character *c, ITEM_TYPES type)
 {
-    if (type == COOLANT_CANISTER && c->coolant != NULL) {
+    if (type == COOLANT_CANISTER && c->coolant != NO_ITEM) {
         return true;
     }
 
     for (int i = 0; i < 3; i++) {
-        if (c->held_items[i] != NULL && c->held_items[i]->type == type) {
+        if (c->held_items[i] != NO_ITEM && get_item(manager, c->held_items[i])->type == type) {
             return true;
         }
     }
@@ -85,9 +88,14 @@ bool character_has_item(character *c, ITEM_TYPES type)
     return false;
 }
 
-ability_output *new_ability_output()
+/**
+ * Allocate an ability output in the game's turn scratch, it lasts until the next action menu
+ * @param  manager                Game manager
+ * @return          Pointer to the new ability output
+ */
+ability_output *new_ability_output(struct game_manager *manager)
 {
-    ability_output *out = (ability_output *)malloc(sizeof(ability_output));
+    ability_output *out = (ability_output *)arena_alloc(&manager->turn_scratch, sizeof(ability_output));
     out->use_action = true;
     out->can_use_ability_again = true;
     out->move_character_index = -1;
@@ -95,48 +103,39 @@ ability_output *new_ability_output()
 }
 
 /**
- * The following are character abilities. Each take in the game map, the characters list, and the
- * active character.
+ * The following are character abilities. Each take in the game manager and the active character.
  */
 
-ability_output *ripley_ability(map *game_map, character *characters[5], character *active_character)
+ability_output *ripley_ability(game_manager *manager, character *active_character)
 {
-    ability_output *out = new_ability_output();
-
-    printf("Pick a character to move:\n");
-    int i;
-    for (i = 0; i < 5; i++) {
-        if (characters[i] != NULL) {
-            printf("\t%d) %s at %s\n", i + 1, characters[i]->last_name, characters[i]->current_room->name);
-        } else {
-            break;
-        }
+    ability_output *out = new_ability_output(manager);
+
+    game_print(manager, "Pick a character to move:\n");
+    for (int i = 0; i < manager->character_count; i++) {
+        game_print(manager,
+                   "\t%d) %s at %s\n",
+                   i + 1,
+                   manager->characters[i]->last_name,
+                   manager->characters[i]->current_room->name);
     }
-    printf("\tb) Back\n");
+    game_print(manager, "\tb) Back\n");
 
-    char ch = '\0';
-    while (ch < '0' || ch > '0' + i) {
-        ch = get_character();
-
-        if (ch == 'b') {
-            break;
-        }
-    }
+    char options[7];
+    char ch = get_choice(manager, DECISION_CHARACTER, menu_options(options, manager->character_count, "b"));
 
     if (ch == 'b') {
         out->use_action = false;
         return out;
     } else {
-        ch = ch - '0' - 1;
-        out->move_character_index = ch;
+        out->move_character_index = ch - '0' - 1;
     }
 
     return out;
 }
 
-ability_output *dallas_ability(map *game_map, character *characters[5], character *active_character)
+ability_output *dallas_ability(game_manager *manager, character *active_character)
 {
-    ability_output *out = new_ability_output();
+    ability_output *out = new_ability_output(manager);
     out->use_action = false;
 
     //printf("%s has no ability\n", active_character->last_name);
@@ -144,16 +143,13 @@ ability_output *dallas_ability(map *game_map, character *characters[5], characte
     return out;
 }
 
-ability_output *parker_ability(map *game_map, character *characters[5], character *active_character)
+ability_output *parker_ability(game_manager *manager, character *active_character)
 {
-    ability_output *out = new_ability_output();
+    ability_output *out = new_ability_output(manager);
 
-    printf("Confirm use of this ability? (y/n) ");
+    game_print(manager, "Confirm use of this ability? (y/n) ");
 
-    char ch;
-    while (ch != 'y' && ch != 'n') {
-        ch = get_character();
-    }
+    char ch = get_choice(manager, DECISION_CONFIRM, "yn");
 
     if (ch == 'n') {
         out->use_action = false;
@@ -167,86 +163,89 @@ ability_output *parker_ability(map *game_map, character *characters[5], characte
     return out;
 }
 
-ability_output *brett_ability(map *game_map, character *characters[5], character *active_character)
+ability_output *brett_ability(game_manager *manager, character *active_character)
 {
-    ability_output *out = new_ability_output();
+    ability_output *out = new_ability_output(manager);
     out->use_action = false;
 
-    printf("This ability is latent.\n");
+    game_print(manager, "This ability is latent.\n");
 
     return out;
 }
 
-ability_output *lambert_ability(map *game_map, character *characters[5], character *active_character)
+ability_output *lambert_ability(game_manager *manager, character *active_character)
 {
-    ability_output *out = new_ability_output();
+    ability_output *out = new_ability_output(manager);
 
-    printf("Confirm use of this ability? (y/n) ");
+    game_print(manager, "Confirm use of this ability? (y/n) ");
 
-    char ch;
-    while (ch != 'y' && ch != 'n') {
-        ch = get_character();
-    }
+    char ch = get_choice(manager, DECISION_CONFIRM, "yn");
 
     if (ch == 'n') {
         out->use_action = false;
         return out;
     }
 
-    int discard_index = draw_encounter();
-    ENCOUNTER_TYPES encounter = discard_encounters[discard_index];
+    ENCOUNTER_TYPES encounter = draw_encounter(&manager->encounters, &manager->rng);
 
-    printf("Drawn encounter: %s\n", encounter_names[encounter]);
+    game_print(manager, "Drawn encounter: %s\n", encounter_names[encounter]);
 
-    printf("Discard this encounter? (y/n) ");
+    game_print(manager, "Discard this encounter? (y/n) ");
 
-    ch = '\0';
-    while (ch != 'y' && ch != 'n') {
-        ch = get_character();
-    }
+    ch = get_choice(manager, DECISION_CONFIRM, "yn");
 
     if (ch == 'n') {
-        replace_encounter();
+        return_encounter(&manager->encounters, encounter);
     }
 
     return out;
 }
 
 /**
- * Subtract a use from a character's item and check if it breaks
+ * Subtract a use from a character's item and check if it breaks. Broken items are freed
+ * @param manager     Game manager
  * @param c           Character to check
- * @param i           Pointer to item to check
+ * @param id          Handle of item to check
  */
-void use_item(character *c, item *i)
+void use_item(game_manager *manager, character *c, item_id id)
 {
-    printf("%s uses %s\n", c->last_name, item_names[i->type]);
+    item *i = get_item(manager, id);
+    game_print(manager, "%s uses %s\n", c->last_name, item_names[i->type]);
 
     if (i->uses >= 0) {
         i->uses--;
         if (i->uses <= 0) {
-            printf("%s's %s broke!\n", c->last_name, item_names[i->type]);
+            game_print(manager, "%s's %s broke!\n", c->last_name, item_names[i->type]);
             for (int j = 0; j < 3; j++) {
-                if (c->held_items[j] == i) {
-                    c->held_items[j] = NULL;
+                if (c->held_items[j] == id) {
+                    c->held_items[j] = NO_ITEM;
+                    c->num_items--;
                 }
             }
+            free_item(manager, id);
         }
     }
 }
 
 /**
- * Print the inventory of the provided character
- * @param c  Character whose inventory will be printed
+ * Print the inventory of the provided character to the game's output
+ * @param manager  Game manager
+ * @param c        Character whose inventory will be printed
  */
-void print_inventory(character *c)
+void print_inventory(game_manager *manager, character *c)
 {
-    printf("%s's Inventory:\n", c->last_name);
-    printf("\tScrap: %d\n", c->num_scrap);
-    printf("\tItems:\n");
+    FILE *out = manager->output;
+    if (out == NULL) {
+        return;
+    }
+
+    fprintf(out, "%s's Inventory:\n", c->last_name);
+    fprintf(out, "\tScrap: %d\n", c->num_scrap);
+    fprintf(out, "\tItems:\n");
     for (int m = 0; m < 3; m++) {
-        printf("\t\t");
-        print_item(c->held_items[m]);
+        fprintf(out, "\t\t");
+        print_item(out, get_item(manager, c->held_items[m]));
     }
-    printf("\t\t");
-    print_item(c->coolant);
+    fprintf(out, "\t\t");
+    print_item(out, get_item(manager, c->coolant));
 }
@@ -0,0 +1,433 @@
+/**
+ * @file
+ * @date   16-Oct-2026
+ * @brief Logic for copying games to and from flat game states
+*/
+
+#include <errno.h>
+
+#include "game_state.h"
+
+/**
+ * Get the number of bytes a game state takes up
+ * @param  room_count             Number of rooms in the state's map
+ * @return          Size of the state in bytes
+ */
+size_t game_state_size(int room_count)
+{
+    return sizeof(game_state) + sizeof(room_snapshot) * room_count;
+}
+
+/**
+ * Allocate an empty game state for games on a map
+ * @param  game_map               Map the state's games are played on
+ * @return          Pointer to the new state
+ */
+game_state *new_game_state(const map *game_map)
+{
+    game_state *state = (game_state *)calloc(1, game_state_size(game_map->room_count));
+    state->room_count = game_map->room_count;
+
+    return state;
+}
+
+/**
+ * Allocate a copy of a game state
+ * @param  state                  State to copy
+ * @return          Pointer to the new copy
+ */
+game_state *clone_game_state(const game_state *state)
+{
+    size_t size = game_state_size(state->room_count);
+    game_state *clone = (game_state *)malloc(size);
+    memcpy(clone, state, size);
+
+    return clone;
+}
+
+/**
+ * Copy a game state over another from the same map
+ * @param dest  State to overwrite
+ * @param src   State to copy
+ */
+void copy_game_state(game_state *dest, const game_state *src)
+{
+    memcpy(dest, src, game_state_size(src->room_count));
+}
+
+/**
+ * Check if two game states are the same
+ * @param  a                      First state
+ * @param  b                      Second state
+ * @return          True if the games are in the same state
+ */
+bool game_states_equal(const game_state *a, const game_state *b)
+{
+    return a->room_count == b->room_count && memcmp(a, b, game_state_size(a->room_count)) == 0;
+}
+
+/**
+ * Hash a game state, so games can be checked for being in the same state without keeping a copy
+ * @param  state                  State to hash
+ * @return          64-bit FNV-1a hash of the state's bytes
+ */
+uint64_t hash_game_state(const game_state *state)
+{
+    const unsigned char *bytes = (const unsigned char *)state;
+    size_t size = game_state_size(state->room_count);
+
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    }
+
+    return hash;
+}
+
+/**
+ * Convert an item to an item_snapshot, NULL for an empty slot
+ */
+item_snapshot _capture_item(const item *i)
+{
+    item_snapshot snapshot = {NO_ITEM, 0};
+    if (i != NULL) {
+        snapshot.type = i->type;
+        snapshot.uses = i->uses;
+    }
+
+    return snapshot;
+}
+
+/**
+ * Convert an item_snapshot to a new item, NO_ITEM for an empty slot
+ */
+item_id _restore_item(game_manager *manager, item_snapshot snapshot)
+{
+    if (snapshot.type == NO_ITEM) {
+        return NO_ITEM;
+    }
+
+    item_id id = new_item(manager, snapshot.type);
+    get_item(manager, id)->uses = snapshot.uses;
+
+    return id;
+}
+
+/**
+ * Get the index of an objective in objectives_stack
+ */
+int _objective_index(const objective *o)
+{
+    for (int i = 0; i < NUM_OBJECTIVES; i++) {
+        if (strcmp(o->name, objectives_stack[i].name) == 0) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * Copy a game into a game state
+ * @param manager  Game manager of the game to copy
+ * @param state    State to copy into, allocated for the game's map
+ */
+void capture_game_state(const game_manager *manager, game_state *state)
+{
+    int room_count = manager->game_map->room_count;
+
+    // Clear padding too, so equal games give byte-for-byte equal states
+    memset(state, 0, game_state_size(room_count));
+    state->room_count = room_count;
+
+    state->rng = manager->rng;
+    state->encounters = manager->encounters;
+
+    state->morale = manager->morale;
+    state->round_index = manager->round_index;
+    state->turn_index = manager->turn_index;
+    state->turn_in_progress = manager->turn_in_progress;
+    state->used_ability = manager->used_ability;
+    state->do_encounter = manager->do_encounter;
+
+    state->character_count = manager->character_count;
+    state->num_objectives = manager->num_objectives;
+    state->is_final_mission = manager->is_final_mission;
+    state->final_mission_type = manager->final_mission_type;
+
+    state->xenomorph_location = manager->xenomorph_location->id;
+    state->ash_location = manager->ash_location != NULL ? manager->ash_location->id : NO_ROOM;
+    state->ash_health = manager->ash_health;
+    state->ash_killed = manager->ash_killed;
+    state->jonesy_caught = manager->jonesy_caught;
+
+    for (int i = 0; i < manager->num_objectives; i++) {
+        state->objectives[i] = _objective_index(&manager->game_objectives[i]);
+        state->objectives_completed[i] = manager->game_objectives[i].completed;
+        state->objective_locations[i] = manager->game_objectives[i].location->id;
+    }
+
+    for (int i = 0; i < manager->character_count; i++) {
+        const character *c = manager->characters[i];
+        character_snapshot *snapshot = &state->characters[i];
+
+        snapshot->roster_index = c - manager->roster;
+        snapshot->current_actions = c->current_actions;
+        snapshot->self_destruct_tracker = c->self_destruct_tracker;
+        snapshot->num_items = c->num_items;
+        snapshot->num_scrap = c->num_scrap;
+        snapshot->current_room = c->current_room->id;
+        for (int j = 0; j < 3; j++) {
+            snapshot->held_items[j] = _capture_item(get_item(manager, c->held_items[j]));
+        }
+        snapshot->coolant = _capture_item(get_item(manager, c->coolant));
+    }
+
+    for (int i = 0; i < room_count; i++) {
+        const room_state *r = &manager->room_states[i];
+        room_snapshot *snapshot = &state->rooms[i];
+
+        snapshot->num_scrap = r->num_scrap;
+        snapshot->has_event = r->has_event;
+        snapshot->num_items = r->num_items;
+        for (int j = 0; j < NUM_ROOM_ITEMS; j++) {
+            snapshot->room_items[j] = _capture_item(get_item(manager, r->room_items[j]));
+        }
+    }
+}
+
+/**
+ * Replace a game with the game in a game state, freeing the items it held
+ * @param manager  Game manager to restore into, playing on the state's map
+ * @param state    State to restore
+ */
+void restore_game_state(game_manager *manager, const game_state *state)
+{
+    map *game_map = manager->game_map;
+
+    manager->rng = state->rng;
+    manager->encounters = state->encounters;
+
+    manager->morale = state->morale;
+    manager->round_index = state->round_index;
+    manager->turn_index = state->turn_index;
+    manager->turn_in_progress = state->turn_in_progress;
+    manager->used_ability = state->used_ability;
+    manager->do_encounter = state->do_encounter;
+
+    manager->is_final_mission = state->is_final_mission;
+    manager->final_mission_type = state->final_mission_type;
+
+    manager->xenomorph_location = game_map->rooms[state->xenomorph_location];
+    manager->ash_location = state->ash_location != NO_ROOM ? game_map->rooms[state->ash_location] : NULL;
+    manager->ash_health = state->ash_health;
+    manager->ash_killed = state->ash_killed;
+    manager->jonesy_caught = state->jonesy_caught;
+
+    manager->num_objectives = state->num_objectives;
+    for (int i = 0; i < state->num_objectives; i++) {
+        manager->game_objectives[i] = objectives_stack[(int)state->objectives[i]];
+        manager->game_objectives[i].completed = state->objectives_completed[i];
+        manager->game_objectives[i].location = game_map->rooms[state->objective_locations[i]];
+    }
+
+    // Characters
+    for (int i = 0; i < manager->character_count; i++) {
+        for (int j = 0; j < 3; j++) {
+            free_item(manager, manager->characters[i]->held_items[j]);
+        }
+        free_item(manager, manager->characters[i]->coolant);
+    }
+    memcpy(manager->roster, default_characters, sizeof(manager->roster));
+    manager->character_count = state->character_count;
+    for (int i = 0; i < 5; i++) {
+        manager->characters[i] = NULL;
+    }
+    for (int i = 0; i < state->character_count; i++) {
+        const character_snapshot *snapshot = &state->characters[i];
+        character *c = &manager->roster[(int)snapshot->roster_index];
+
+        c->current_actions = snapshot->current_actions;
+        c->self_destruct_tracker = snapshot->self_destruct_tracker;
+        c->num_items = snapshot->num_items;
+        c->num_scrap = snapshot->num_scrap;
+        c->current_room = game_map->rooms[snapshot->current_room];
+        for (int j = 0; j < 3; j++) {
+            c->held_items[j] = _restore_item(manager, snapshot->held_items[j]);
+        }
+        c->coolant = _restore_item(manager, snapshot->coolant);
+
+        manager->characters[i] = c;
+    }
+    manager->active_character = manager->characters[manager->turn_index];
+
+    // Rooms
+    for (int i = 0; i < game_map->room_count; i++) {
+        const room_snapshot *snapshot = &state->rooms[i];
+        room_state *r = &manager->room_states[i];
+
+        r->num_scrap = snapshot->num_scrap;
+        r->has_event = snapshot->has_event;
+        r->num_items = snapshot->num_items;
+        for (int j = 0; j < NUM_ROOM_ITEMS; j++) {
+            free_item(manager, r->room_items[j]);
+            r->room_items[j] = _restore_item(manager, snapshot->room_items[j]);
+        }
+    }
+}
+
+/**
+ * Write a game state to a save file
+ * @param  state                  State to save
+ * @param  game_map               Map the state's game is played on
+ * @param  fn                     Filename of the save file
+ * @param  error                  Filled in with the reason if the file can't be written
+ * @return          True on success
+ */
+bool save_game_state(const game_state *state, const map *game_map, const char *fn, map_error *error)
+{
+    save_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SAVE_MAGIC, sizeof(SAVE_MAGIC));
+    header.version = SAVE_VERSION;
+    header.byte_order = SAVE_BYTE_ORDER;
+    header.state_size = game_state_size(state->room_count);
+    header.room_count = game_map->room_count;
+    memcpy(header.map_name, game_map->name, sizeof(header.map_name));
+
+    FILE *fp = fopen(fn, "wb");
+    if (fp == NULL) {
+        return map_error_at(error, 0, 0, "Failed to create save file: %s", strerror(errno));
+    }
+
+    bool written = fwrite(&header, sizeof(header), 1, fp) == 1 && fwrite(state, header.state_size, 1, fp) == 1;
+    written &= fclose(fp) == 0;
+    if (!written) {
+        return map_error_at(error, 0, 0, "Failed to write save file: %s", strerror(errno));
+    }
+
+    return true;
+}
+
+/**
+ * Check that every index in a state read from a file is in range for its map
+ */
+bool _game_state_in_range(const game_state *state)
+{
+    int room_count = state->room_count;
+
+    bool valid = state->character_count >= 1 && state->character_count <= 5 && state->turn_index >= 0 &&
+                 state->turn_index < state->character_count && state->num_objectives >= 0 &&
+                 state->num_objectives <= NUM_OBJECTIVES && state->xenomorph_location < room_count &&
+                 (state->ash_location == NO_ROOM || state->ash_location < room_count) &&
+                 (state->is_final_mission
+                      ? state->final_mission_type >= 0 && state->final_mission_type < NUM_FINAL_MISSIONS
+                      : state->final_mission_type == -1);
+
+    for (int i = 0; valid && i < state->num_objectives; i++) {
+        valid = state->objectives[i] >= 0 && state->objectives[i] < NUM_OBJECTIVES &&
+                state->objective_locations[i] < room_count;
+    }
+
+    // Each character is in the game at most once, and holds as many items as its count says
+    bool in_game[5] = {false};
+    for (int i = 0; valid && i < state->character_count; i++) {
+        const character_snapshot *c = &state->characters[i];
+        valid = c->roster_index >= 0 && c->roster_index < 5 && !in_game[(int)c->roster_index] &&
+                c->current_room < room_count;
+        if (valid) {
+            in_game[(int)c->roster_index] = true;
+        }
+
+        int num_items = 0;
+        for (int j = 0; valid && j < 3; j++) {
+            valid = c->held_items[j].type >= NO_ITEM && c->held_items[j].type < NUM_ITEM_TYPES;
+            num_items += c->held_items[j].type != NO_ITEM;
+        }
+        valid = valid && c->num_items == num_items && c->coolant.type >= NO_ITEM && c->coolant.type < NUM_ITEM_TYPES;
+    }
+
+    for (int i = 0; valid && i < room_count; i++) {
+        int num_items = 0;
+        for (int j = 0; valid && j < NUM_ROOM_ITEMS; j++) {
+            valid = state->rooms[i].room_items[j].type >= NO_ITEM && state->rooms[i].room_items[j].type < NUM_ITEM_TYPES;
+            num_items += state->rooms[i].room_items[j].type != NO_ITEM;
+        }
+        valid = valid && state->rooms[i].num_items == num_items;
+    }
+
+    // Every card of the deck is either in the stack or the discard pile, and the counts agree with the stack
+    const encounter_stack *stack = &state->encounters;
+    valid = valid && stack->num_encounters >= 0 && stack->num_encounters <= ENCOUNTER_STACK_SIZE;
+
+    int in_stack[NUM_ENCOUNTER_TYPES] = {0};
+    int in_deck[NUM_ENCOUNTER_TYPES] = {0};
+    for (int i = 0; valid && i < stack->num_encounters; i++) {
+        valid = stack->encounters[i] >= QUIET && stack->encounters[i] < NUM_ENCOUNTER_TYPES;
+        if (valid) {
+            in_stack[stack->encounters[i]]++;
+        }
+    }
+    for (int i = 0; i < ENCOUNTER_STACK_SIZE; i++) {
+        in_deck[encounter_deck[i]]++;
+    }
+    for (int i = 0; valid && i < NUM_ENCOUNTER_TYPES; i++) {
+        valid = stack->remaining[i] == in_stack[i] && stack->remaining[i] + stack->discarded[i] == in_deck[i];
+    }
+
+    return valid;
+}
+
+/**
+ * Read a game state from a save file
+ * @param  fn                     Filename of the save file
+ * @param  game_map               Map to play the saved game on, which must be the map it was saved on
+ * @param  error                  Filled in with the reason if the file can't be loaded
+ * @return          Pointer to the new state, NULL on failure
+ */
+game_state *load_game_state(const char *fn, const map *game_map, map_error *error)
+{
+    FILE *fp = fopen(fn, "rb");
+    if (fp == NULL) {
+        map_error_at(error, 0, 0, "Failed to open save file: %s", strerror(errno));
+        return NULL;
+    }
+
+    save_header header;
+    if (fread(&header, sizeof(header), 1, fp) != 1 || memcmp(header.magic, SAVE_MAGIC, sizeof(SAVE_MAGIC)) != 0) {
+        fclose(fp);
+        map_error_at(error, 0, 0, "Not a save file");
+        return NULL;
+    } else if (header.version != SAVE_VERSION) {
+        fclose(fp);
+        map_error_at(error, 0, 0, "Save file is version %u, this build reads version %d", header.version, SAVE_VERSION);
+        return NULL;
+    } else if (header.byte_order != SAVE_BYTE_ORDER) {
+        fclose(fp);
+        map_error_at(error, 0, 0, "Save file was written on a machine with a different byte order");
+        return NULL;
+    } else if (header.room_count != game_map->room_count ||
+               strncmp(header.map_name, game_map->name, sizeof(header.map_name)) != 0 ||
+               header.state_size != game_state_size(game_map->room_count)) {
+        fclose(fp);
+        map_error_at(error, 0, 0, "Save file is of a game on another map");
+        return NULL;
+    }
+
+    game_state *state = new_game_state(game_map);
+    if (fread(state, header.state_size, 1, fp) != 1 || state->room_count != game_map->room_count) {
+        fclose(fp);
+        free(state);
+        map_error_at(error, 0, 0, "Save file is truncated");
+        return NULL;
+    }
+    fclose(fp);
+
+    if (!_game_state_in_range(state)) {
+        free(state);
+        map_error_at(error, 0, 0, "Save file is corrupt");
+        return NULL;
+    }
+
+    return state;
+}
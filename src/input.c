@@ -0,0 +1,196 @@
+/**
+ * @file
+ * @date   16-Oct-2026
+ * @brief Terminal, scripted, and random input providers
+*/
+
+#include "input.h"
+#include "manager.h"
+
+/**
+ * Read a key from stdin, ending the game if stdin closes
+ */
+char _terminal_choose(input_provider *self, struct game_manager *manager, DECISION_TYPES decision, const char *options)
+{
+    char ch = get_character();
+    if (ch == '\0' && feof(stdin)) {
+        printf("\n");
+        if (manager->end_of_game == NULL) {
+            // Only character selection asks for decisions outside of game_loop, and exiting it ends the game
+            return 'e';
+        }
+        end_game(manager, GAME_EXITED);
+    }
+
+    return ch;
+}
+
+/**
+ * Release a provider that holds no resources besides itself
+ */
+void _free_input(input_provider *self)
+{
+    free(self);
+}
+
+/**
+ * Create the default provider, which reads one key per line from the terminal
+ * @return  Pointer to the new provider
+ */
+input_provider *new_terminal_input()
+{
+    input_provider *provider = (input_provider *)malloc(sizeof(input_provider));
+    provider->choose = _terminal_choose;
+    provider->free = _free_input;
+
+    return provider;
+}
+
+/**
+ * Answer with the next key of the script, or ask the fallback provider once it runs out
+ */
+char _scripted_choose(input_provider *self, struct game_manager *manager, DECISION_TYPES decision, const char *options)
+{
+    scripted_input *script = (scripted_input *)self;
+
+    if (script->position < script->num_choices) {
+        return script->choices[script->position++];
+    } else if (script->fallback != NULL) {
+        return script->fallback->choose(script->fallback, manager, decision, options);
+    }
+
+    fprintf(stderr, "[ERROR] - Input script ended before the game did\n");
+    exit(1);
+}
+
+/**
+ * Release a scripted provider and its fallback
+ */
+void _free_scripted_input(input_provider *self)
+{
+    scripted_input *script = (scripted_input *)self;
+
+    if (script->fallback != NULL) {
+        script->fallback->free(script->fallback);
+    }
+    free(script->choices);
+    free(script);
+}
+
+/**
+ * Create a provider that answers decisions with a fixed sequence of keys
+ * @param  choices                Keys to answer with, in order
+ * @param  fallback               Provider to ask once `choices` runs out, NULL to end the game instead.
+ *                                The scripted provider takes ownership of it
+ * @return          Pointer to the new provider
+ */
+input_provider *new_scripted_input(const char *choices, input_provider *fallback)
+{
+    scripted_input *script = (scripted_input *)malloc(sizeof(scripted_input));
+    script->provider.choose = _scripted_choose;
+    script->provider.free = _free_scripted_input;
+
+    script->num_choices = strlen(choices);
+    script->choices = (char *)malloc(script->num_choices + 1);
+    strcpy(script->choices, choices);
+    script->position = 0;
+    script->fallback = fallback;
+
+    return (input_provider *)script;
+}
+
+/**
+ * Create a scripted provider from a file with the same input the terminal takes: the first character
+ * of each line is one key, and empty lines answer with a newline
+ * @param  fn                     Filename of the script
+ * @param  fallback               Provider to ask once the script runs out, see new_scripted_input
+ * @return          Pointer to the new provider, NULL if the file can't be opened
+ */
+input_provider *read_input_script(const char *fn, input_provider *fallback)
+{
+    FILE *fp = fopen(fn, "r");
+    if (fp == NULL) {
+        return NULL;
+    }
+
+    int capacity = 64;
+    int num_choices = 0;
+    char *choices = (char *)malloc(capacity);
+
+    char *line = NULL;
+    size_t line_capacity = 0;
+    while (getline(&line, &line_capacity, fp) != -1) {
+        if (num_choices + 1 == capacity) {
+            capacity *= 2;
+            choices = (char *)realloc(choices, capacity);
+        }
+
+        choices[num_choices++] = line[0];
+    }
+    choices[num_choices] = '\0';
+
+    free(line);
+    fclose(fp);
+
+    input_provider *provider = new_scripted_input(choices, fallback);
+    free(choices);
+
+    return provider;
+}
+
+/**
+ * Collect the answers to a decision that bots consider: every option except exiting the game, and except
+ * information-only action menu picks
+ * @param  decision               Kind of decision being made
+ * @param  options                Keys that are valid answers
+ * @param  candidates             Filled with the answers, at least MAX_BOT_CHOICES characters
+ * @return          Number of answers in `candidates`
+ */
+int get_bot_choices(DECISION_TYPES decision, const char *options, char *candidates)
+{
+    int num_candidates = 0;
+    for (const char *c = options; *c != '\0' && num_candidates < MAX_BOT_CHOICES; c++) {
+        if (*c == 'e' && (decision == DECISION_ACTION || decision == DECISION_PICK_CHARACTER)) {
+            continue;
+        }
+        if (decision == DECISION_ACTION && strchr(INFORMATION_ACTIONS, *c) != NULL) {
+            continue;
+        }
+
+        candidates[num_candidates++] = *c;
+    }
+
+    return num_candidates;
+}
+
+/**
+ * Pick a random valid answer. Bots never exit the game, and never spend action menu picks on information
+ */
+char _random_choose(input_provider *self, struct game_manager *manager, DECISION_TYPES decision, const char *options)
+{
+    random_input *bot = (random_input *)self;
+
+    char candidates[MAX_BOT_CHOICES];
+    int num_candidates = get_bot_choices(decision, options, candidates);
+    if (num_candidates == 0) {
+        return options[0];
+    }
+
+    return candidates[random_below(&bot->rng, num_candidates)];
+}
+
+/**
+ * Create a bot that answers every decision at random
+ * @param  seed                   Seed for the bot's random choices
+ * @param  stream                 Random stream for the bot's choices, see seed_random
+ * @return          Pointer to the new provider
+ */
+input_provider *new_random_input(uint64_t seed, uint64_t stream)
+{
+    random_input *bot = (random_input *)malloc(sizeof(random_input));
+    bot->provider.choose = _random_choose;
+    bot->provider.free = _free_input;
+    seed_random(&bot->rng, seed, stream);
+
+    return (input_provider *)bot;
+}
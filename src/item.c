@@ -6,6 +6,7 @@
 */
 
 #include "item.h"
+#include "manager.h"
 
 int item_costs[NUM_ITEM_TYPES] = {2, 3, 3, 4, 3, 1, -1};
 
@@ -34,47 +35,76 @@ int item_uses[NUM_ITEM_TYPES] = {-1, -1, 2, 2, 2, 1, 1};
 
 /**
  * Print the details of an existing item
- * @param i  Pointer to item to print
+ * @param out  Stream to print to, NULL to print nothing
+ * @param i    Pointer to item to print
  */
-void print_item(item *i)
+void print_item(FILE *out, const item *i)
 {
+    if (out == NULL) {
+        return;
+    }
+
     if (i == NULL) {
-        printf("NONE\n");
+        fprintf(out, "NONE\n");
     } else {
-        printf("%s:", item_names[i->type]);
+        fprintf(out, "%s:", item_names[i->type]);
         if (i->uses >= 0) {
-            printf(" %d uses - ", i->uses);
+            fprintf(out, " %d uses - ", i->uses);
         } else {
-            printf(" inf uses - ");
+            fprintf(out, " inf uses - ");
         }
-        printf("%s\n", item_desc[i->type]);
+        fprintf(out, "%s\n", item_desc[i->type]);
     }
 }
 
 /**
  * Print the details of an item type
+ * @param out   Stream to print to, NULL to print nothing
  * @param type  Type of item to print
  */
-void print_item_type(ITEM_TYPES type, int discount)
+void print_item_type(FILE *out, ITEM_TYPES type, int discount)
 {
-    printf("%s: Costs %d Scrap", item_names[type], item_costs[type] - discount);
+    if (out == NULL) {
+        return;
+    }
+
+    fprintf(out, "%s: Costs %d Scrap", item_names[type], item_costs[type] - discount);
     if (item_uses[type] >= 0) {
-        printf(", %d uses\n", item_uses[type]);
+        fprintf(out, ", %d uses\n", item_uses[type]);
     } else {
-        printf(", inf uses\n");
+        fprintf(out, ", inf uses\n");
     }
 }
 
 /**
- * Instantiate a new item of type `type`
+ * Take an unused item from a game's item pool and make it a new item of type `type`
+ * @param  manager            Game manager of the game the item is in
  * @param  type               Type of item to instantiate
- * @return      Pointer to instantiated item
+ * @return      Handle of the instantiated item
  */
-item *new_item(ITEM_TYPES type)
+item_id new_item(struct game_manager *manager, ITEM_TYPES type)
 {
-    item *out = (item *)malloc(sizeof(item));
+    if (manager->num_free_items <= 0) {
+        fprintf(stderr, "[ERROR] - The game's item pool is empty\n");
+        exit(1);
+    }
+
+    item_id id = manager->free_items[--manager->num_free_items];
+    item *out = &manager->items[id];
     out->type = type;
     out->uses_action = item_uses_actions[type];
     out->uses = item_uses[type];
-    return out;
+    return id;
+}
+
+/**
+ * Return an item made by new_item to its game's item pool
+ * @param manager  Game manager of the game the item is in
+ * @param id       Handle of the item, or NO_ITEM to do nothing
+ */
+void free_item(struct game_manager *manager, item_id id)
+{
+    if (id != NO_ITEM) {
+        manager->free_items[manager->num_free_items++] = id;
+    }
 }
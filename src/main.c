@@ -8,10 +8,15 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include "arguments.h"
+#include "game_state.h"
 #include "manager.h"
+#include "map/compiled_map.h"
 #include "map/map.h"
+#include "mcts.h"
+#include "replay.h"
 
 const char *DEFAULT_MAP = "/var/games/aftn/game_data/maps/default";
 const char *BANNER = "/var/games/aftn/game_data/banner.txt";
@@ -19,7 +24,7 @@ const char *BANNER = "/var/games/aftn/game_data/banner.txt";
 const char *argp_program_version = "aftn 0.0.1";
 const char *argp_program_bug_address = "charles@utdallas.edu";
 static char doc[] = "A C port of Alien: Fate of The Nostromo, a 2021 board game of the same name";
-static char args_doc[] = "";
+static char args_doc[] = "[OUT]";
 
 static struct argp_option options[] = {{"n_players", 'n', "integer", 0, "Number of players to create"},
                                        {"n_characters", 'c', "integer", 0, "Number of characters to create"},
@@ -32,6 +37,64 @@ static struct argp_option options[] = {{"n_players", 'n', "integer", 0, "Number
                                         "/var/games/aftn/maps/format.txt to create your own game boards"},
                                        {"print_map", 'p', 0, 0, "Print out a text representation of the game map"},
                                        {"draw_map", 'd', 0, 0, "Draw the game map if an ASCII map is provided"},
+                                       {"compile-map",
+                                        COMPILE_MAP_KEY,
+                                        "IN",
+                                        0,
+                                        "Compile the map file IN into a binary map image at OUT, then exit. "
+                                        "Compiled maps load faster and can be passed to --game"},
+                                       {"quiet", 'q', 0, 0, "Play without printing anything"},
+                                       {"script",
+                                        's',
+                                        "FILE",
+                                        0,
+                                        "Read input from this file, one key per line, before reading from the terminal"},
+                                       {"bot", 'b', 0, 0, "Let a bot make random decisions instead of reading from the terminal"},
+                                       {"seed",
+                                        SEED_KEY,
+                                        "integer",
+                                        0,
+                                        "Seed for the game's random events and the bot's decisions, defaults to the "
+                                        "current time. Games with the same seed and input play out the same way"},
+                                       {"ai",
+                                        AI_KEY,
+                                        "integer",
+                                        0,
+                                        "Let the crew AI play this many characters, the last ones in the turn order. "
+                                        "The rest are played from the terminal, script, or bot"},
+                                       {"ai_iterations",
+                                        AI_ITERATIONS_KEY,
+                                        "integer",
+                                        0,
+                                        "Rollouts the crew AI plays for each decision, 0 for no limit"},
+                                       {"ai_time",
+                                        AI_TIME_KEY,
+                                        "ms",
+                                        0,
+                                        "Milliseconds the crew AI searches each decision for, 0 for no limit"},
+                                       {"ai_threads",
+                                        AI_THREADS_KEY,
+                                        "integer",
+                                        0,
+                                        "Number of threads the crew AI searches on, defaults to the number of processors"},
+                                       {"record",
+                                        RECORD_KEY,
+                                        "FILE",
+                                        0,
+                                        "Record the game's seed and every decision to a replay log at this path"},
+                                       {"replay",
+                                        REPLAY_KEY,
+                                        "FILE",
+                                        0,
+                                        "Replay the game recorded in this log without printing it, check that it "
+                                        "ends the same way, then exit"},
+                                       {"save",
+                                        SAVE_KEY,
+                                        "FILE",
+                                        0,
+                                        "Save file the w and f keys of the action menu save the game to and load it "
+                                        "from, defaults to aftn.sav"},
+                                       {"load", LOAD_KEY, "FILE", 0, "Resume the game saved in this file"},
                                        {0}};
 
 static struct argp argp = {options, parse_opt, args_doc, doc, 0, 0, 0};
@@ -42,36 +105,94 @@ int main(int argc, char *argv[])
     struct arguments arguments;
     arguments.n_players = 1;
     arguments.n_characters = 1;
+    arguments.crew = 0;
     arguments.use_ash = false;
     strcpy(arguments.game_file, DEFAULT_MAP);
     arguments.print_map = false;
     arguments.draw_map = false;
+    arguments.compile_map = false;
+    arguments.quiet = false;
+    arguments.input_script[0] = '\0';
+    arguments.bot = false;
+    arguments.seed = time(0);
+    arguments.ai_characters = 0;
+    arguments.ai_iterations = MCTS_DEFAULT_ITERATIONS;
+    arguments.ai_time = 0;
+    arguments.ai_threads = sysconf(_SC_NPROCESSORS_ONLN);
+    arguments.record_file[0] = '\0';
+    arguments.replay_file[0] = '\0';
+    strcpy(arguments.save_file, "aftn.sav");
+    arguments.load_file[0] = '\0';
     argp_parse(&argp, argc, argv, 0, 0, &arguments);
 
+    if (arguments.compile_map) {
+        map_error error;
+        map *game_map = read_map(arguments.compile_map_input, &error);
+        if (game_map == NULL) {
+            print_map_error(arguments.compile_map_input, &error);
+            exit(1);
+        }
+
+        if (!write_compiled_map(game_map, arguments.compile_map_output, &error)) {
+            print_map_error(arguments.compile_map_output, &error);
+            exit(1);
+        }
+
+        free_map(game_map);
+        exit(0);
+    }
+
+    if (arguments.replay_file[0] != '\0') {
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        replay_summary summary;
+        map_error error;
+        if (!replay_game(arguments.replay_file, &summary, &error)) {
+            print_map_error(arguments.replay_file, &error);
+            exit(1);
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        print_replay_summary(stdout, &summary);
+        fprintf(stderr,
+                "Replayed in %.3f ms\n",
+                (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6);
+
+        exit(summary.complete && !summary.matches ? 1 : 0);
+    }
+
     if (arguments.n_players > 1) {
         fprintf(stderr, "[UNIMPLEMENTED] - Multiplayer is not yet implemented\n");
         exit(1);
     }
 
     // Print banner
-    FILE *fp;
-    fp = fopen(BANNER, "r");
-    if (fp == NULL) {
-        fprintf(stderr, "[ERROR] - Could not open banner file %s\n", BANNER);
-        exit(1);
-    }
+    if (!arguments.quiet) {
+        FILE *fp;
+        fp = fopen(BANNER, "r");
+        if (fp == NULL) {
+            fprintf(stderr, "[ERROR] - Could not open banner file %s\n", BANNER);
+            exit(1);
+        }
 
-    char line[128];
-    while (fgets(line, 127, fp)) {
-        printf("%s", line);
-    }
+        char line[128];
+        while (fgets(line, 127, fp)) {
+            printf("%s", line);
+        }
 
-    fclose(fp);
+        fclose(fp);
+    }
 
-    map *game_map = read_map(arguments.game_file);
+    map_error error;
+    map *game_map = read_map(arguments.game_file, &error);
+    if (game_map == NULL) {
+        print_map_error(arguments.game_file, &error);
+        exit(1);
+    }
 
     if (arguments.print_map) {
-        print_map(game_map);
+        print_map(stdout, game_map);
         exit(0);
     }
 
@@ -80,20 +201,98 @@ int main(int argc, char *argv[])
         exit(0);
     }
 
+    // Resumed games keep the characters they were saved with
+    game_state *saved = NULL;
+    if (arguments.load_file[0] != '\0') {
+        saved = load_game_state(arguments.load_file, game_map, &error);
+        if (saved == NULL) {
+            print_map_error(arguments.load_file, &error);
+            exit(1);
+        }
+        arguments.n_characters = saved->character_count;
+    }
+
+    // Set up input
+    input_provider *input = arguments.bot ? new_random_input(arguments.seed, 1) : new_terminal_input();
+    if (arguments.input_script[0] != '\0') {
+        input_provider *script = read_input_script(arguments.input_script, input);
+        if (script == NULL) {
+            fprintf(stderr, "[ERROR] - Could not open input script %s\n", arguments.input_script);
+            exit(1);
+        }
+        input = script;
+    }
+
+    mcts_input *ai = NULL;
+    if (arguments.ai_characters > 0) {
+        if (arguments.ai_characters > arguments.n_characters) {
+            fprintf(stderr, "[ERROR] - The crew AI can't play more than the %d characters\n", arguments.n_characters);
+            exit(1);
+        }
+
+        mcts_settings settings;
+        settings.iterations = arguments.ai_iterations;
+        settings.time_limit = arguments.ai_time;
+        settings.threads = arguments.ai_threads;
+        settings.horizon = 2;
+        settings.seed = arguments.seed;
+        input = new_mcts_input(settings, arguments.n_characters - arguments.ai_characters, input);
+        ai = (mcts_input *)input;
+    }
+
+    // Record outermost, so the log holds every decision no matter who made it
+    input_provider *recorder = NULL;
+    if (arguments.record_file[0] != '\0') {
+        if (saved != NULL) {
+            fprintf(stderr, "[ERROR] - Replay logs start from a new game, so resumed games can't be recorded\n");
+            exit(1);
+        }
+
+        map_error error;
+        recorder = new_recording_input(arguments.record_file, &arguments, game_map, input, &error);
+        if (recorder == NULL) {
+            fprintf(stderr, "[ERROR] - Could not create replay log %s: %s\n", arguments.record_file, error.message);
+            exit(1);
+        }
+        input = recorder;
+    }
+
     // Create new game
-    game_manager *manager = new_game(arguments, game_map);
+    random_state rng;
+    seed_random(&rng, arguments.seed, 0);
+    game_manager *manager;
+    NEW_GAME_RESULTS created = NEW_GAME_CREATED;
+    if (saved != NULL) {
+        manager = new_game_from_state(saved, game_map, input, arguments.quiet ? NULL : stdout);
+        free(saved);
+        if (manager == NULL) {
+            created = NEW_GAME_OUT_OF_MEMORY;
+        }
+    } else {
+        manager = new_game(arguments, game_map, rng, input, arguments.quiet ? NULL : stdout, &created);
+    }
+    if (created == NEW_GAME_OUT_OF_MEMORY) {
+        fprintf(stderr, "[ERROR] - Not enough memory for a game on %s\n", arguments.game_file);
+        exit(1);
+    }
 
     // Start game loop
-    game_loop(manager);
-
-    for (int i = 0; i < game_map->room_count; i++) {
-        free(game_map->rooms[i]);
+    if (manager != NULL) {
+        manager->save_file = arguments.save_file;
+        manager->recording = recorder != NULL;
+        game_outcome outcome = game_loop(manager);
+        if (recorder != NULL) {
+            finish_recording(recorder, manager, outcome);
+        }
+        free_game(manager);
     }
 
-    free(game_map->ascii_map);
-    free(game_map);
+    if (ai != NULL) {
+        print_mcts_statistics(stderr, ai);
+    }
 
-    free(manager);
+    input->free(input);
+    free_map(game_map);
 
     return 0;
 }
@@ -5,24 +5,123 @@
  * @brief Logic for the game manager, primarily the game loop and some graph functions
 */
 
+#include <stdarg.h>
+
 #include "manager.h"
+#include "game_state.h"
+
+// Values game_loop's end_of_game is jumped to with
+// The game ended, see end_game
+#define GAME_OVER_JUMP 1
+// The game was replaced by a saved game, which play resumes from, see load_game
+#define GAME_LOADED_JUMP 2
+
+/**
+ * Bytes of memory a game on a map needs, see the memory field of game_manager
+ */
+size_t _game_memory_size(const map *game_map)
+{
+    int max_items = MAX_GAME_ITEMS(game_map->room_count);
+
+    return ARENA_SIZE(sizeof(game_manager)) + GAME_TURN_SCRATCH_SIZE + search_scratch_size(game_map) +
+           ARENA_SIZE(sizeof(room_state) * game_map->room_count) + ARENA_SIZE(sizeof(objective) * NUM_OBJECTIVES) +
+           ARENA_SIZE(sizeof(item) * max_items) + ARENA_SIZE(sizeof(item_id) * max_items);
+}
+
+/**
+ * Allocate a game manager with its per-game memory, and no game set up on it yet
+ * @param  game_map               The processed game map
+ * @param  input                  Where the game's decisions come from
+ * @param  output                 Where the game's text goes, NULL to print nothing
+ * @return          Pointer to the new game manager, NULL if there isn't enough memory for the game
+ */
+game_manager *_new_manager(map *game_map, input_provider *input, FILE *output)
+{
+    // The whole game is one allocation, with the manager first so that freeing it frees everything
+    size_t size = _game_memory_size(game_map);
+    void *block = malloc(size);
+    if (block == NULL) {
+        return NULL;
+    }
+    arena memory;
+    init_arena(&memory, block, size);
+    game_manager *manager = (game_manager *)arena_alloc(&memory, sizeof(game_manager));
+    manager->memory = memory;
+
+    init_arena(&manager->turn_scratch, arena_alloc(&manager->memory, GAME_TURN_SCRATCH_SIZE), GAME_TURN_SCRATCH_SIZE);
+
+    // Every item the game can hold, handed out lowest handle first
+    int max_items = MAX_GAME_ITEMS(game_map->room_count);
+    manager->items = (item *)arena_alloc(&manager->memory, sizeof(item) * max_items);
+    manager->free_items = (item_id *)arena_alloc(&manager->memory, sizeof(item_id) * max_items);
+    for (int i = 0; i < max_items; i++) {
+        manager->free_items[i] = max_items - 1 - i;
+    }
+    manager->num_free_items = max_items;
+
+    // Game input and output
+    manager->input = input;
+    manager->output = output;
+    manager->save_file = NULL;
+    manager->recording = false;
+
+    // Play until the game is won or lost, recording nothing
+    manager->max_rounds = 0;
+    manager->morale_history = NULL;
+    manager->morale_history_length = 0;
+    manager->end_of_game = NULL;
+
+    // Map setup
+    manager->game_map = game_map;
+    manager->scratch = alloc_search_scratch(game_map, &manager->memory);
+    manager->room_states = (room_state *)arena_alloc(&manager->memory, sizeof(room_state) * game_map->room_count);
+    memset(manager->room_states, 0, sizeof(room_state) * game_map->room_count);
+    for (int i = 0; i < game_map->room_count; i++) {
+        for (int j = 0; j < NUM_ROOM_ITEMS; j++) {
+            manager->room_states[i].room_items[j] = NO_ITEM;
+        }
+    }
+
+    memcpy(manager->roster, default_characters, sizeof(manager->roster));
+    for (int i = 0; i < 5; i++) {
+        manager->characters[i] = NULL;
+    }
+    manager->character_count = 0;
+    manager->num_objectives = 0;
+    manager->game_objectives = (objective *)arena_alloc(&manager->memory, sizeof(objective) * NUM_OBJECTIVES);
+
+    return manager;
+}
 
 /**
  * Creates new game manager
  * @param  args                   Command-line arguments read with argp
  * @param  game_map               The processed game map
- * @return          Pointer to the new game manager
+ * @param  rng                    Seeded generator for the game's random events
+ * @param  input                  Where the game's decisions come from
+ * @param  output                 Where the game's text goes, NULL to print nothing
+ * @param  result                 Set to whether the game was made, and why not if it wasn't
+ * @return          Pointer to the new game manager, NULL if a player exited during character selection or
+ *                  there isn't enough memory for the game
  */
-game_manager *new_game(const arguments args, map *game_map)
+game_manager *new_game(const arguments args,
+                       map *game_map,
+                       random_state rng,
+                       input_provider *input,
+                       FILE *output,
+                       NEW_GAME_RESULTS *result)
 {
-    game_manager *manager = (game_manager *)malloc(sizeof(game_manager));
+    game_manager *manager = _new_manager(game_map, input, output);
+    if (manager == NULL) {
+        *result = NEW_GAME_OUT_OF_MEMORY;
+        return NULL;
+    }
+
+    manager->rng = rng;
 
     // Team morale
     manager->morale = args.n_players > 3 ? 20 : 15;
 
-    // Map setup
-    manager->game_map = game_map;
-
     // Initialize Xenomorph and Ash locations
     manager->xenomorph_location = manager->game_map->xenomorph_start_room;
     if (args.use_ash) {
@@ -30,6 +129,8 @@ game_manager *new_game(const arguments args, map *game_map)
     } else {
         manager->ash_location = NULL;
     }
+    manager->ash_health = 0;
+    manager->ash_killed = false;
 
     // Place initial scrap
     for (int i = 0; i < manager->game_map->scrap_room_count; i++) {
@@ -37,38 +138,51 @@ game_manager *new_game(const arguments args, map *game_map)
             continue;
         }
 
-        manager->game_map->scrap_rooms[i]->num_scrap = 2;
+        get_room_state(manager, manager->game_map->scrap_rooms[i])->num_scrap = 2;
     }
 
     // Place initial events
     for (int i = 0; i < manager->game_map->event_room_count; i++) {
-        manager->game_map->event_rooms[i]->has_event = true;
+        get_room_state(manager, manager->game_map->event_rooms[i])->has_event = true;
     }
 
     // Place initial coolant
     for (int i = 0; i < manager->game_map->coolant_room_count; i++) {
-        manager->game_map->coolant_rooms[i]->room_items[manager->game_map->coolant_rooms[i]->num_items++] =
-            new_item(COOLANT_CANISTER);
+        room_state *state = get_room_state(manager, manager->game_map->coolant_rooms[i]);
+        state->room_items[state->num_items++] = new_item(manager, COOLANT_CANISTER);
     }
 
     // Game setup
     manager->round_index = 1;
     manager->turn_index = 0;
+    manager->turn_in_progress = false;
+    manager->used_ability = false;
+    manager->do_encounter = false;
 
     // Character selection
-    if (args.n_characters == 5) {
+    if (args.crew != 0) {
+        int count = 0;
         for (int i = 0; i < 5; i++) {
-            manager->characters[i] = &characters[i];
+            if (args.crew & (1 << i)) {
+                manager->characters[count] = &manager->roster[i];
+                manager->characters[count++]->current_room = manager->game_map->player_start_room;
+            }
+        }
+        // The crew decides how many characters there are, whatever n_characters says
+        manager->character_count = count;
+    } else if (args.n_characters == 5) {
+        for (int i = 0; i < 5; i++) {
+            manager->characters[i] = &manager->roster[i];
             manager->characters[i]->current_room = manager->game_map->player_start_room;
         }
+        manager->character_count = 5;
     } else {
         int picked[5] = {-1, -1, -1, -1, -1};
-        for (int i = 0; i < 5; i++) {
-            manager->characters[i] = NULL;
-        }
         for (int i = 0; i < args.n_characters; i++) {
-            printf("Pick character %d:\n", i + 1);
+            game_print(manager, "Pick character %d:\n", i + 1);
 
+            char options[7];
+            int num_options = 0;
             for (int j = 0; j < 5; j++) {
                 int already_picked = 0;
                 for (int k = 0; k < 5; k++) {
@@ -80,48 +194,49 @@ game_manager *new_game(const arguments args, map *game_map)
                     continue;
                 }
 
-                printf("%d) %s, %s - %d Actions - Special Ability: %s\n",
-                       j + 1,
-                       characters[j].last_name,
-                       characters[j].first_name,
-                       characters[j].max_actions,
-                       characters[j].ability_description);
+                game_print(manager,
+                           "%d) %s, %s - %d Actions - Special Ability: %s\n",
+                           j + 1,
+                           manager->roster[j].last_name,
+                           manager->roster[j].first_name,
+                           manager->roster[j].max_actions,
+                           manager->roster[j].ability_description);
+                options[num_options++] = '1' + j;
             }
-            printf("e) Exit\n");
-
-            char ch = '\0';
-            while (ch < '1' || ch > '5') {
-                ch = get_character();
-                if (ch == 'e') {
-                    exit(0);
-                }
+            game_print(manager, "e) Exit\n");
+            options[num_options++] = 'e';
+            options[num_options] = '\0';
+
+            char ch = get_choice(manager, DECISION_PICK_CHARACTER, options);
+            if (ch == 'e') {
+                manager->character_count = i;
+                free_game(manager);
+                *result = NEW_GAME_EXITED;
+                return NULL;
             }
 
             int selection = ch - '0' - 1;
             picked[i] = selection;
-            manager->characters[i] = &characters[selection];
+            manager->characters[i] = &manager->roster[selection];
 
             manager->characters[i]->current_room = manager->game_map->player_start_room;
         }
+        manager->character_count = args.n_characters;
     }
-    manager->character_count = args.n_characters;
-
-    // Set random seed
-    srand(time(0));
 
     // Get objectives
     manager->num_objectives = manager->character_count + 1;
-    manager->num_objectives = 1;
-    manager->game_objectives = get_objectives(manager->num_objectives);
+    get_objectives(manager->game_objectives, manager->num_objectives, &manager->rng);
     for (int i = 0; i < manager->num_objectives; i++) {
         room *tmp = get_room(manager->game_map, manager->game_objectives[i].location_name);
         if (tmp != NULL) {
             manager->game_objectives[i].location = tmp;
         } else {
-            printf("[WARNING] - Objective room names are hardcoded, should have a room of name %s.\nSetting location "
-                   "to %s.\n",
-                   manager->game_objectives[i].location_name,
-                   manager->game_map->player_start_room->name);
+            game_print(manager,
+                       "[WARNING] - Objective room names are hardcoded, should have a room of name %s.\n"
+                       "Setting location to %s.\n",
+                       manager->game_objectives[i].location_name,
+                       manager->game_map->player_start_room->name);
             manager->game_objectives[i].location = manager->game_map->player_start_room;
         }
     }
@@ -132,21 +247,106 @@ game_manager *new_game(const arguments args, map *game_map)
     manager->jonesy_caught = false;
 
     // Shuffle encounter deck
-    shuffle_encounters();
+    reset_encounters(&manager->encounters);
+    shuffle_encounters(&manager->encounters, &manager->rng);
 
+    *result = NEW_GAME_CREATED;
     return manager;
 }
 
+/**
+ * Creates a game manager for a game restored from a game state
+ * @param  state                  State of the game to restore
+ * @param  game_map               The processed game map the state was captured on
+ * @param  input                  Where the game's decisions come from
+ * @param  output                 Where the game's text goes, NULL to print nothing
+ * @return          Pointer to the new game manager, NULL if there isn't enough memory for the game
+ */
+game_manager *new_game_from_state(const struct game_state *state, map *game_map, input_provider *input, FILE *output)
+{
+    game_manager *manager = _new_manager(game_map, input, output);
+    if (manager == NULL) {
+        return NULL;
+    }
+    restore_game_state(manager, state);
+
+    return manager;
+}
+
+/**
+ * Free a game manager and everything the game allocated. The map and input provider aren't freed, the
+ * map is never changed by a game so it can be used for other games
+ * @param manager  Game manager to free
+ */
+void free_game(game_manager *manager)
+{
+    // Everything the game allocated is in the manager's memory
+    free(manager);
+}
+
+/**
+ * printf to the game's output, if it has any. The arguments are evaluated either way, so headless games
+ * behave the same as printed ones
+ * @param manager  Game manager
+ * @param format   printf format string
+ */
+void game_print(const game_manager *manager, const char *format, ...)
+{
+    if (manager->output == NULL) {
+        return;
+    }
+
+    va_list args;
+    va_start(args, format);
+    vfprintf(manager->output, format, args);
+    va_end(args);
+}
+
+/**
+ * Ask the game's input provider for a decision until it answers with one of the valid options
+ * @param  manager                Game manager
+ * @param  decision               Kind of decision being made
+ * @param  options                Keys that are valid answers
+ * @return          The chosen key
+ */
+char get_choice(game_manager *manager, DECISION_TYPES decision, const char *options)
+{
+    char ch = '\0';
+    while (ch == '\0' || strchr(options, ch) == NULL) {
+        ch = manager->input->choose(manager->input, manager, decision, options);
+    }
+
+    return ch;
+}
+
+/**
+ * Write the keys of a numbered menu into an options string for get_choice
+ * @param  options                Buffer of at least 10 + strlen(extra_keys) characters
+ * @param  num_entries            Number of entries numbered from 1, at most 9
+ * @param  extra_keys             Other valid keys, like b to go back
+ * @return          options
+ */
+char *menu_options(char *options, int num_entries, const char *extra_keys)
+{
+    int length = 0;
+    for (int i = 0; i < num_entries && i < 9; i++) {
+        options[length++] = '1' + i;
+    }
+    strcpy(options + length, extra_keys);
+
+    return options;
+}
+
 /**
  * Print the game objectives
  * @param manager  Game manager
  */
 void print_game_objectives(game_manager *manager)
 {
-    printf("Objectives are:\n");
+    game_print(manager, "Objectives are:\n");
     for (int i = 0; i < manager->num_objectives; i++) {
-        printf("\t");
-        print_objective_description(manager->game_objectives[i]);
+        game_print(manager, "\t");
+        print_objective_description(manager->output, manager->game_objectives[i]);
     }
 }
 
@@ -162,8 +362,8 @@ void update_objectives(game_manager *manager)
             case BRING_ITEM_TO_LOCATION:
                 for (int j = 0; j < manager->character_count; j++) {
                     if (manager->characters[j]->current_room == manager->game_objectives[i].location &&
-                        character_has_item(manager->characters[j], manager->game_objectives[i].target_item_type)) {
-                        complete_objective(&(manager->game_objectives[i]));
+                        character_has_item(manager, manager->characters[j], manager->game_objectives[i].target_item_type)) {
+                        complete_objective(manager->output, &(manager->game_objectives[i]));
                         break;
                     }
                 }
@@ -178,20 +378,21 @@ void update_objectives(game_manager *manager)
                 }
 
                 if (all_at_location_with_scrap) {
-                    complete_objective(&(manager->game_objectives[i]));
+                    complete_objective(manager->output, &(manager->game_objectives[i]));
                 }
                 break;
             case DROP_COOLANT:;
+                room_state *location_state = get_room_state(manager, manager->game_objectives[i].location);
                 int coolant_count = 0;
                 for (int j = 0; j < NUM_ROOM_ITEMS; j++) {
-                    if (manager->game_objectives[i].location->room_items[j] != NULL &&
-                        manager->game_objectives[i].location->room_items[j]->type == COOLANT_CANISTER) {
+                    if (location_state->room_items[j] != NO_ITEM &&
+                        get_item(manager, location_state->room_items[j])->type == COOLANT_CANISTER) {
                         coolant_count++;
                     }
                 }
 
                 if (coolant_count >= 2) {
-                    complete_objective(&(manager->game_objectives[i]));
+                    complete_objective(manager->output, &(manager->game_objectives[i]));
                 }
                 break;
             }
@@ -206,13 +407,12 @@ void update_objectives(game_manager *manager)
         }
 
         if (all_complete) {
-            printf("[OBJECTIVE] - Completed all objectives\n");
+            game_print(manager, "[OBJECTIVE] - Completed all objectives\n");
             manager->is_final_mission = true;
             do {
-                manager->final_mission_type = randint(0, NUM_FINAL_MISSIONS - 1);
+                manager->final_mission_type = randint(&manager->rng, 0, NUM_FINAL_MISSIONS - 1);
             } while (manager->character_count == 1 && (manager->final_mission_type == CUT_OFF_EVERY_BULKHEAD_AND_VENT ||
                                                        manager->final_mission_type == BLOW_IT_OUT_INTO_SPACE));
-            manager->final_mission_type = WERE_GOING_TO_BLOW_UP_THE_SHIP;
             setup_final_mission(manager);
         }
     } else {
@@ -226,23 +426,29 @@ void update_objectives(game_manager *manager)
  */
 void setup_final_mission(game_manager *manager)
 {
-    printf("[FINAL OBJECTIVE] - You have a new mission!\n");
-    printf("-----%s------\n", final_mission_names[manager->final_mission_type]);
-    printf("%s\n", final_mission_desc[manager->final_mission_type]);
+    game_print(manager, "[FINAL OBJECTIVE] - You have a new mission!\n");
+    game_print(manager, "-----%s------\n", final_mission_names[manager->final_mission_type]);
+    game_print(manager, "%s\n", final_mission_desc[manager->final_mission_type]);
 
     switch (manager->final_mission_type) {
     case YOU_HAVE_MY_SYMPATHIES:;
         // Fill equipment storage or galley with coolant
-        room *yequipment_storage = get_room(manager->game_map, "EQUIPMENT STORAGE");
+        room *yequipment_storage = manager->game_map->equipment_storage;
         if (yequipment_storage == NULL) {
             yequipment_storage = manager->game_map->player_start_room;
         }
-        for (int i = 0; i < manager->character_count + 2; i++) {
-            yequipment_storage->room_items[i] = new_item(COOLANT_CANISTER);
+        room_state *ystorage_state = get_room_state(manager, yequipment_storage);
+        int ycoolant_count = min(manager->character_count + 2, NUM_ROOM_ITEMS);
+        for (int i = 0; i < ycoolant_count; i++) {
+            if (ystorage_state->room_items[i] == NO_ITEM) {
+                ystorage_state->num_items++;
+            } else {
+                free_item(manager, ystorage_state->room_items[i]);
+            }
+            ystorage_state->room_items[i] = new_item(manager, COOLANT_CANISTER);
         }
-        yequipment_storage->num_items = max(yequipment_storage->num_items, manager->character_count + 2);
         // Put Ash at MU-TH-UR
-        manager->ash_location = get_room(manager->game_map, "MU-TH-UR");
+        manager->ash_location = manager->game_map->mu_th_ur;
         if (manager->ash_location == NULL) {
             manager->ash_location = manager->game_map->ash_start_room;
         }
@@ -251,37 +457,49 @@ void setup_final_mission(game_manager *manager)
         break;
     case ESCAPE_ON_THE_NARCISSUS:;
         // Fill equipment storage or galley with coolant
-        room *eequipment_storage = get_room(manager->game_map, "EQUIPMENT STORAGE");
+        room *eequipment_storage = manager->game_map->equipment_storage;
         if (eequipment_storage == NULL) {
             eequipment_storage = manager->game_map->player_start_room;
         }
-        for (int i = 0; i < manager->character_count + 2; i++) {
-            eequipment_storage->room_items[i] = new_item(COOLANT_CANISTER);
+        room_state *estorage_state = get_room_state(manager, eequipment_storage);
+        int ecoolant_count = min(manager->character_count + 2, NUM_ROOM_ITEMS);
+        for (int i = 0; i < ecoolant_count; i++) {
+            if (estorage_state->room_items[i] == NO_ITEM) {
+                estorage_state->num_items++;
+            } else {
+                free_item(manager, estorage_state->room_items[i]);
+            }
+            estorage_state->room_items[i] = new_item(manager, COOLANT_CANISTER);
         }
-        eequipment_storage->num_items = max(eequipment_storage->num_items, manager->character_count + 2);
         break;
     case BLOW_IT_OUT_INTO_SPACE:
         // Replace and shuffle encounters
-        replace_all_encounters();
-        shuffle_encounters();
+        replace_all_encounters(&manager->encounters, &manager->rng);
+        shuffle_encounters(&manager->encounters, &manager->rng);
         break;
     case WERE_GOING_TO_BLOW_UP_THE_SHIP:;
         // Fill equipment storage or galley with coolant
-        room *wequipment_storage = get_room(manager->game_map, "EQUIPMENT STORAGE");
+        room *wequipment_storage = manager->game_map->equipment_storage;
         if (wequipment_storage == NULL) {
             wequipment_storage = manager->game_map->player_start_room;
         }
-        for (int i = 0; i < manager->character_count + 2; i++) {
-            wequipment_storage->room_items[i] = new_item(COOLANT_CANISTER);
+        room_state *wstorage_state = get_room_state(manager, wequipment_storage);
+        int wcoolant_count = min(manager->character_count + 2, NUM_ROOM_ITEMS);
+        for (int i = 0; i < wcoolant_count; i++) {
+            if (wstorage_state->room_items[i] == NO_ITEM) {
+                wstorage_state->num_items++;
+            } else {
+                free_item(manager, wstorage_state->room_items[i]);
+            }
+            wstorage_state->room_items[i] = new_item(manager, COOLANT_CANISTER);
         }
-        wequipment_storage->num_items = max(wequipment_storage->num_items, manager->character_count + 2);
         // Give self destruct tracker to active character
         manager->active_character->self_destruct_tracker = 4;
         break;
     case CUT_OFF_EVERY_BULKHEAD_AND_VENT:
         // Add events to every named room
         for (int i = 0; i < manager->game_map->named_room_count; i++) {
-            manager->game_map->rooms[manager->game_map->named_room_indices[i]]->has_event = true;
+            manager->room_states[manager->game_map->named_room_indices[i]].has_event = true;
         }
         // Give self destruct tracker to active character
         manager->active_character->self_destruct_tracker = 4;
@@ -306,15 +524,16 @@ void update_final_mission(game_manager *manager)
         break;
     case ESCAPE_ON_THE_NARCISSUS:;
         // Win when all members in docking bay with 1 coolant dropped in docking bay each, with cat carrier and incinerator in inventory
-        room *docking_bay = get_room(manager->game_map, "DOCKING BAY");
+        room *docking_bay = manager->game_map->docking_bay;
         if (docking_bay == NULL) {
             docking_bay = manager->game_map->player_start_room;
         }
+        room_state *docking_bay_state = get_room_state(manager, docking_bay);
 
         // Check coolant
         int num_canisters = 0;
         for (int i = 0; i < NUM_ROOM_ITEMS; i++) {
-            if (docking_bay->room_items[i] != NULL && docking_bay->room_items[i]->type == COOLANT_CANISTER) {
+            if (docking_bay_state->room_items[i] != NO_ITEM && get_item(manager, docking_bay_state->room_items[i])->type == COOLANT_CANISTER) {
                 num_canisters++;
             }
         }
@@ -328,10 +547,10 @@ void update_final_mission(game_manager *manager)
             if (manager->characters[i]->current_room != docking_bay) {
                 all_in_docking_bay = false;
             }
-            if (character_has_item(manager->characters[i], CAT_CARRIER)) {
+            if (character_has_item(manager, manager->characters[i], CAT_CARRIER)) {
                 has_carrier = true;
             }
-            if (character_has_item(manager->characters[i], INCINERATOR)) {
+            if (character_has_item(manager, manager->characters[i], INCINERATOR)) {
                 has_incinerator = true;
             }
         }
@@ -349,13 +568,13 @@ void update_final_mission(game_manager *manager)
         game_won = true;
 
         // Get airlock or galley
-        room *airlock = get_room(manager->game_map, "AIRLOCK");
+        room *airlock = manager->game_map->airlock;
         if (airlock == NULL) {
             airlock = manager->game_map->player_start_room;
         }
 
         for (int i = 0; i < manager->character_count; i++) {
-            if (manager->characters[i]->current_room != airlock || manager->characters[i]->num_scrap == 0 || manager->characters[i]->coolant == NULL) {
+            if (manager->characters[i]->current_room != airlock || manager->characters[i]->num_scrap == 0 || manager->characters[i]->coolant == NO_ITEM) {
                 game_won = false;
             }
         }
@@ -364,7 +583,7 @@ void update_final_mission(game_manager *manager)
         // Win if all events are gone
         game_won = true;
         for (int i = 0; i < manager->game_map->named_room_count; i++) {
-            if (manager->game_map->rooms[manager->game_map->named_room_indices[i]]->has_event) {
+            if (manager->room_states[manager->game_map->named_room_indices[i]].has_event) {
                 game_won = false;
             }
         }
@@ -381,61 +600,91 @@ void update_final_mission(game_manager *manager)
  */
 void win_game(game_manager *manager)
 {
-    printf("[FINAL OBJECTIVE] - Complete! You Win!\n");
-    exit(0);
+    game_print(manager, "[FINAL OBJECTIVE] - Complete! You Win!\n");
+    end_game(manager, GAME_WON);
+}
+
+/**
+ * End the game, returning its outcome from game_loop. Nothing the game allocated may be held only by a
+ * local variable when this is called, as the functions between here and game_loop don't return
+ * @param manager  Game manager
+ * @param result   How the game ended
+ */
+void end_game(game_manager *manager, GAME_RESULTS result)
+{
+    manager->outcome.result = result;
+    manager->outcome.round = manager->round_index;
+    manager->outcome.turn = manager->turn_index;
+
+    longjmp(*manager->end_of_game, GAME_OVER_JUMP);
 }
 
 /**
  * Move a character
  * @param  manager                     Game manager
  * @param  to_move                     Character to move
- * @param  allowed_moves               room_queue containing allowed destinations
+ * @param  allowed_moves               Array of allowed destinations, NULL to allow adjacent rooms
+ * @param  num_allowed_moves           Length of allowed_moves
  * @param  allow_back                  Whether or not to allow the user to exit the movement menu
  * @return               Pointer to the room the player moved the character to
  */
-room *character_move(game_manager *manager, struct character *to_move, room_queue *allowed_moves, bool allow_back)
+room *character_move(game_manager *manager,
+                     struct character *to_move,
+                     room **allowed_moves,
+                     int num_allowed_moves,
+                     bool allow_back)
 {
+    int num_destinations = allowed_moves == NULL ? room_connection_count(manager->game_map, to_move->current_room)
+                                                 : num_allowed_moves;
+    num_destinations = min(num_destinations, 9);
+
+    char options[12];
+    menu_options(options, num_destinations, "");
+    if (allowed_moves == NULL && to_move->current_room->ladder_connection != NULL) {
+        strcat(options, "l");
+    }
+    if (allow_back) {
+        strcat(options, "b");
+    }
+
     // Get selection
     char ch = '\0';
     while (1) {
         // Print choices
-        printf("Destinations:\n");
+        game_print(manager, "Destinations:\n");
         if (allowed_moves == NULL) {
             // Move to adjacent rooms
-            for (int i = 0; i < to_move->current_room->connection_count; i++) {
-                printf("\t%d) %s\n", i + 1, to_move->current_room->connections[i]->name);
+            for (int i = 0; i < num_destinations; i++) {
+                game_print(manager, "\t%d) %s\n", i + 1, room_connection(manager->game_map, to_move->current_room, i)->name);
             }
             if (to_move->current_room->ladder_connection != NULL) {
-                printf("\tl) Ladder to %s\n", to_move->current_room->ladder_connection->name);
+                game_print(manager, "\tl) Ladder to %s\n", to_move->current_room->ladder_connection->name);
             }
         } else {
             // Move to rooms defined in allowed_moves
-            for (int i = 0; i < allowed_moves->size; i++) {
-                printf("\t%d) %s\n", i + 1, poll_position(allowed_moves, i)->name);
+            for (int i = 0; i < num_destinations; i++) {
+                game_print(manager, "\t%d) %s\n", i + 1, allowed_moves[i]->name);
             }
         }
         if (allow_back) {
-            printf("\tb) Back\n");
+            game_print(manager, "\tb) Back\n");
         }
 
-        // Get input
-        ch = get_character();
-
-        int max_destination_index =
-            allowed_moves == NULL ? to_move->current_room->connection_count : allowed_moves->size;
+        // Get input, printing the menu again if it isn't a valid choice
+        ch = manager->input->choose(manager->input, manager, DECISION_MOVE, options);
 
         update_objectives(manager);
 
-        if (allow_back && ch == 'b') {
+        if (ch == '\0' || strchr(options, ch) == NULL) {
+            continue;
+        } else if (ch == 'b') {
             return to_move->current_room;
-        } else if (allowed_moves == NULL && ch == 'l') {
+        } else if (ch == 'l') {
             return to_move->current_room->ladder_connection;
-        } else if (ch >= '0' && ch <= max_destination_index + '0') {
-            if (allowed_moves == NULL) {
-                return to_move->current_room->connections[ch - '0' - 1];
-            } else {
-                return poll_position(allowed_moves, ch - '0' - 1);
-            }
+        } else if (allowed_moves == NULL) {
+            return room_connection(manager->game_map, to_move->current_room, ch - '0' - 1);
+        } else {
+            return allowed_moves[ch - '0' - 1];
         }
     }
 
@@ -446,90 +695,6 @@ room *character_move(game_manager *manager, struct character *to_move, room_queu
     return NULL;
 }
 
-/**
- * Find the shortest path between two rooms using a modified Djikstra's algorithm
- * @param  game_map               Game map
- * @param  source                 Source room
- * @param  target                 Target room
- * @return          A room queue containing the path [target ... source]
- */
-room_queue *shortest_path(map *game_map, room *source, room *target)
-{
-    // Set all to unvisited and distance to inf
-    reset_search(game_map, INT_MAX);
-    // Set start vertex (xeno room) distance to 0
-    source->search_distance = 0;
-
-    // Create queue of rooms
-    room_queue *rq = new_room_queue(64);
-    for (int i = 0; i < game_map->room_count; i++) {
-        push(rq, game_map->rooms[i]);
-    }
-
-    while (rq->head != NULL) {
-        // Get closest node
-        int min_node_distance = INT_MAX;
-        room *min_node = rq->head;
-        room *tmp = rq->head;
-        while (tmp != NULL) {
-            if (tmp->search_distance < min_node_distance) {
-                min_node_distance = tmp->search_distance;
-                min_node = tmp;
-            }
-            tmp = tmp->room_queue_next;
-        }
-
-        if (min_node == target) {
-            room_queue *shortest_path = new_room_queue(64);
-            if (min_node->search_previous_room != NULL || min_node == source) {
-                while (min_node != NULL) {
-                    push(shortest_path, min_node);
-                    min_node = min_node->search_previous_room;
-                }
-
-                free(rq);
-                return shortest_path;
-            }
-        }
-
-        // Remove closest node from rq
-        if (min_node == rq->head) {
-            rq->head = rq->head->room_queue_next;
-        } else {
-            room *traverse = rq->head;
-            while (traverse->room_queue_next != min_node) {
-                traverse = traverse->room_queue_next;
-            }
-            traverse->room_queue_next = min_node->room_queue_next;
-        }
-
-        // For each connection of min_node in rq
-        if (min_node != NULL) {
-            for (int i = 0; i < min_node->connection_count; i++) {
-                room *neighbor = min_node->connections[i];
-                if (queue_contains(rq, neighbor)) {
-                    int alt = min_node->search_distance + 1;
-                    if (alt < neighbor->search_distance) {
-                        neighbor->search_distance = alt;
-                        neighbor->search_previous_room = min_node;
-                    }
-                }
-            }
-
-            if (queue_contains(rq, min_node->ladder_connection)) {
-                int alt = min_node->search_distance + 1;
-                if (alt < min_node->ladder_connection->search_distance) {
-                    min_node->ladder_connection->search_distance = alt;
-                    min_node->ladder_connection->search_previous_room = min_node;
-                }
-            }
-        }
-    }
-
-    free(rq);
-    return NULL;
-}
-
 /**
  * Move the xenomorph towards the nearest player and check for interceptions
  * @param  manager                   Game manager
@@ -539,31 +704,23 @@ room_queue *shortest_path(map *game_map, room *source, room *target)
  */
 bool xeno_move(game_manager *manager, int num_spaces, int morale_drop)
 {
-    // Get shortest path to a character
-    room_queue *shortest = NULL;
-    int s = INT_MAX;
+    // Find the closest character
+    bool *targets = clear_targets(manager->scratch);
     for (int i = 0; i < manager->character_count; i++) {
-        room_queue *rq =
-            shortest_path(manager->game_map, manager->xenomorph_location, manager->characters[i]->current_room);
-
-        if (rq != NULL && rq->size < s) {
-            if (shortest != NULL) {
-                free(shortest);
-            }
-
-            shortest = rq;
-            s = rq->size;
-        }
+        targets[manager->characters[i]->current_room->id] = true;
     }
 
+    int s;
+    room *first_step;
+    room *target = find_nearest_room(
+        manager->game_map, manager->xenomorph_location, targets, manager->scratch, &s, &first_step);
+
     // Move xeno along path
-    if (s < num_spaces) {
-        manager->xenomorph_location = shortest->head;
-    } else if (num_spaces > 0) {
-        for (int i = 0; i < num_spaces && shortest->head->room_queue_next != NULL; i++) {
-            pop_tail(shortest);
+    if (target != NULL && num_spaces > 0 && s > 0) {
+        manager->xenomorph_location = first_step;
+        for (int i = 1; i < num_spaces && manager->xenomorph_location != target; i++) {
+            manager->xenomorph_location = next_room_towards(manager->game_map, manager->xenomorph_location, target, manager->scratch);
         }
-        manager->xenomorph_location = shortest->tail;
     }
 
     // Check if xeno intercepts characters
@@ -572,7 +729,7 @@ bool xeno_move(game_manager *manager, int num_spaces, int morale_drop)
         if (manager->characters[i]->current_room == manager->xenomorph_location) {
             if (!printed_message) {
                 printed_message = true;
-                printf("The Xenomorph meets you in %s!\n", manager->xenomorph_location->name);
+                game_print(manager, "The Xenomorph meets you in %s!\n", manager->xenomorph_location->name);
             }
 
             reduce_morale(manager, morale_drop, true);
@@ -580,8 +737,6 @@ bool xeno_move(game_manager *manager, int num_spaces, int morale_drop)
         }
     }
 
-    free(shortest);
-
     return printed_message;
 }
 
@@ -598,70 +753,48 @@ bool ash_move(game_manager *manager, int num_spaces)
     }
 
     if (manager->is_final_mission && manager->final_mission_type != YOU_HAVE_MY_SYMPATHIES) {
-        manager->ash_location->num_scrap = 0;
+        get_room_state(manager, manager->ash_location)->num_scrap = 0;
     }
 
-    // Get shortest path to a character or a room with scrap
-    room_queue *shortest = NULL;
-    int s = INT_MAX;
+    // Find the closest character or room with scrap
+    bool *targets = clear_targets(manager->scratch);
     // Scrap check
     for (int i = 0; manager->final_mission_type != YOU_HAVE_MY_SYMPATHIES && i < manager->game_map->room_count; i++) {
-        if (manager->game_map->rooms[i]->num_scrap == 0) {
-            continue;
-        }
-
-        room_queue *rq = shortest_path(manager->game_map, manager->ash_location, manager->game_map->rooms[i]);
-
-        if (rq != NULL && rq->size < s) {
-            if (shortest != NULL) {
-                free(shortest);
-            }
-
-            shortest = rq;
-            s = rq->size;
-        }
+        targets[i] = manager->room_states[i].num_scrap > 0;
     }
     // Character check
     for (int i = 0; i < manager->character_count; i++) {
         // Ash only moves if nobody is with him
         if (manager->is_final_mission && manager->final_mission_type != YOU_HAVE_MY_SYMPATHIES &&
             manager->characters[i]->current_room == manager->ash_location) {
-            if (shortest != NULL) {
-                free(shortest);
-            }
-
             return false;
         }
 
-        room_queue *rq = shortest_path(manager->game_map, manager->ash_location, manager->characters[i]->current_room);
-
-        if (rq != NULL && rq->size < s) {
-            if (shortest != NULL) {
-                free(shortest);
-            }
-
-            shortest = rq;
-            s = rq->size;
-        }
+        targets[manager->characters[i]->current_room->id] = true;
     }
 
+    int s;
+    room *first_step;
+    room *target =
+        find_nearest_room(manager->game_map, manager->ash_location, targets, manager->scratch, &s, &first_step);
+
     // Move Ash along path
-    if (s < num_spaces) {
-        manager->ash_location = shortest->head;
+    if (target != NULL && s + 1 < num_spaces) {
+        manager->ash_location = target;
         if (manager->final_mission_type != YOU_HAVE_MY_SYMPATHIES) {
-            manager->ash_location->num_scrap = 0;
+            get_room_state(manager, manager->ash_location)->num_scrap = 0;
         }
 
-        ash_move(manager, num_spaces - s);
-    } else if (num_spaces > 0) {
-        for (int i = 0; i < num_spaces && shortest->head->room_queue_next != NULL; i++) {
-            pop_tail(shortest);
+        ash_move(manager, num_spaces - s - 1);
+    } else if (target != NULL && num_spaces > 0 && s > 0) {
+        manager->ash_location = first_step;
+        for (int i = 1; i < num_spaces && manager->ash_location != target; i++) {
+            manager->ash_location = next_room_towards(manager->game_map, manager->ash_location, target, manager->scratch);
         }
-        manager->ash_location = shortest->tail;
     }
 
     if (manager->final_mission_type != YOU_HAVE_MY_SYMPATHIES) {
-        manager->ash_location->num_scrap = 0;
+        get_room_state(manager, manager->ash_location)->num_scrap = 0;
     }
 
     // Check if Ash intercepts characters
@@ -670,46 +803,46 @@ bool ash_move(game_manager *manager, int num_spaces)
         if (manager->characters[i]->current_room == manager->ash_location) {
             if (!printed_message) {
                 printed_message = true;
-                printf("Ash meets you in %s!\n", manager->ash_location->name);
+                game_print(manager, "Ash meets you in %s!\n", manager->ash_location->name);
             }
 
             if (manager->final_mission_type != YOU_HAVE_MY_SYMPATHIES) {
                 if (manager->characters[i]->num_scrap > 0) {
-                    printf("%s loses 1 Scrap!\n", manager->characters[i]->last_name);
+                    game_print(manager, "%s loses 1 Scrap!\n", manager->characters[i]->last_name);
                     manager->characters[i]->num_scrap--;
                 } else {
-                    printf("%s has no Scrap!\n", manager->characters[i]->last_name);
+                    game_print(manager, "%s has no Scrap!\n", manager->characters[i]->last_name);
                     reduce_morale(manager, 1, false);
                 }
             } else {
-                if (character_has_item(manager->characters[i], COOLANT_CANISTER)) {
-                    printf("%s uses COOLANT CANISTER to hurt Ash!\n", manager->characters[i]->last_name);
+                if (character_has_item(manager, manager->characters[i], COOLANT_CANISTER)) {
+                    game_print(manager, "%s uses COOLANT CANISTER to hurt Ash!\n", manager->characters[i]->last_name);
 
-                    free(manager->characters[i]->coolant);
-                    manager->characters[i]->coolant = NULL;
+                    free_item(manager, manager->characters[i]->coolant);
+                    manager->characters[i]->coolant = NO_ITEM;
 
                     manager->ash_health -= 1;
 
                     // Move Ash
-                    room_queue *ash_locations =
-                        find_rooms_by_distance(manager->game_map, manager->ash_location, 3, false);
-
-                    printf("Where to send Ash to?\n");
-                    for (int i = 0; i < ash_locations->size; i++) {
-                        printf("\t%d) %s\n", i + 1, poll_position(ash_locations, i)->name);
-                    }
+                    int num_ash_locations =
+                        find_rooms_by_distance(manager->game_map, manager->ash_location, 3, false, manager->scratch);
+                    num_ash_locations = min(num_ash_locations, 9);
+                    room **ash_locations = manager->scratch->results;
+
+                    // Ash stays put if there's nowhere to send him
+                    if (num_ash_locations > 0) {
+                        game_print(manager, "Where to send Ash to?\n");
+                        for (int i = 0; i < num_ash_locations; i++) {
+                            game_print(manager, "\t%d) %s\n", i + 1, ash_locations[i]->name);
+                        }
 
-                    char ch = '\0';
-                    while (ch < '1' || ch > '0' + ash_locations->size) {
-                        ch = get_character();
+                        char options[10];
+                        menu_options(options, num_ash_locations, "");
+                        int selection = get_choice(manager, DECISION_TARGET_ROOM, options) - '0' - 1;
+                        game_print(manager, "Ash retreats to %s!\n", ash_locations[selection]->name);
+                        manager->ash_location = ash_locations[selection];
                     }
-
-                    ch = ch - '0' - 1;
-                    printf("Ash retreats to %s!\n", poll_position(ash_locations, ch)->name);
-                    manager->ash_location = poll_position(ash_locations, ch);
                     i = 0;
-
-                    free(ash_locations);
                 } else {
                     reduce_morale(manager, 3, false);
                     flee(manager, manager->characters[i]);
@@ -720,8 +853,6 @@ bool ash_move(game_manager *manager, int num_spaces)
         }
     }
 
-    free(shortest);
-
     return printed_message;
 }
 
@@ -730,9 +861,9 @@ void check_ash_health(game_manager *manager)
     if (manager->is_final_mission && manager->final_mission_type == YOU_HAVE_MY_SYMPATHIES && !manager->ash_killed) {
         if (manager->ash_health == 0) {
             manager->ash_killed = true;
-            printf("[FINAL OBJECTIVE] - You've killed Ash! Use an INCINERATOR on the Xenomorph to escape!\n");
+            game_print(manager, "[FINAL OBJECTIVE] - You've killed Ash! Use an INCINERATOR on the Xenomorph to escape!\n");
         } else {
-            printf("[FINAL OBJECTIVE] - Ash health = %d\n", manager->ash_health);
+            game_print(manager, "[FINAL OBJECTIVE] - Ash health = %d\n", manager->ash_health);
         }
     }
 }
@@ -756,13 +887,13 @@ int reduce_morale(game_manager *manager, int lost, bool encountered_alien)
     int prod_index;
     for (int i = 0; i < manager->character_count; i++) {
         for (int j = 0; j < 3; j++) {
-            if (manager->characters[i]->held_items[j] != NULL &&
-                manager->characters[i]->held_items[j]->type == FLASHLIGHT) {
+            if (manager->characters[i]->held_items[j] != NO_ITEM &&
+                get_item(manager, manager->characters[i]->held_items[j])->type == FLASHLIGHT) {
                 char_has_flashlight = manager->characters[i];
                 flashlight_index = j;
                 has_flashlight = true;
-            } else if (encountered_alien && manager->characters[i]->held_items[j] != NULL &&
-                       manager->characters[i]->held_items[j]->type == ELECTRIC_PROD) {
+            } else if (encountered_alien && manager->characters[i]->held_items[j] != NO_ITEM &&
+                       get_item(manager, manager->characters[i]->held_items[j])->type == ELECTRIC_PROD) {
                 char_has_prod = manager->characters[i];
                 prod_index = j;
                 has_prod = true;
@@ -773,57 +904,51 @@ int reduce_morale(game_manager *manager, int lost, bool encountered_alien)
     char ch = '\0';
     if (has_flashlight ^ has_prod) {
         if (has_flashlight) {
-            printf("%s has a FLASHLIGHT. Use it to reduce morale lost by 1? (y/n) ", char_has_flashlight->last_name);
+            game_print(manager, "%s has a FLASHLIGHT. Use it to reduce morale lost by 1? (y/n) ", char_has_flashlight->last_name);
 
-            while (ch != 'y' && ch != 'n') {
-                ch = get_character();
-            }
+            ch = get_choice(manager, DECISION_CONFIRM, "yn");
 
             if (ch == 'y') {
-                lost = min(0, lost - 1);
-                use_item(char_has_flashlight, char_has_flashlight->held_items[flashlight_index]);
+                lost = max(0, lost - 1);
+                use_item(manager, char_has_flashlight, char_has_flashlight->held_items[flashlight_index]);
             }
         } else {
-            printf("%s has an ELECTRIC PROD. Use it to reduce morale lost by 2? (y/n) ", char_has_prod->last_name);
+            game_print(manager, "%s has an ELECTRIC PROD. Use it to reduce morale lost by 2? (y/n) ", char_has_prod->last_name);
 
-            while (ch != 'y' && ch != 'n') {
-                ch = get_character();
-            }
+            ch = get_choice(manager, DECISION_CONFIRM, "yn");
 
             if (ch == 'y') {
-                lost = min(0, lost - 2);
-                use_item(char_has_prod, char_has_prod->held_items[prod_index]);
+                lost = max(0, lost - 2);
+                use_item(manager, char_has_prod, char_has_prod->held_items[prod_index]);
             }
         }
     } else if (has_flashlight && has_prod) {
-        printf("An ELECTRIC PROD and FLASHLIGHT are held by ");
+        game_print(manager, "An ELECTRIC PROD and FLASHLIGHT are held by ");
 
         if (char_has_flashlight == char_has_prod) {
-            printf("%s.", char_has_flashlight->last_name);
+            game_print(manager, "%s.", char_has_flashlight->last_name);
         } else {
-            printf("%s and %s.", char_has_flashlight->last_name, char_has_prod->last_name);
+            game_print(manager, "%s and %s.", char_has_flashlight->last_name, char_has_prod->last_name);
         }
 
-        printf("\n\t1) Use ELECTRIC PROD\n\t2) Use FLASHLIGHT\n\tb) Do not use item\n");
+        game_print(manager, "\n\t1) Use ELECTRIC PROD\n\t2) Use FLASHLIGHT\n\tb) Do not use item\n");
 
-        while (ch != '1' && ch != '2' && ch != 'b') {
-            ch = get_character();
-        }
+        ch = get_choice(manager, DECISION_MORALE_ITEM, "12b");
 
         if (ch == '1') {
-            lost = min(0, lost - 2);
-            use_item(char_has_prod, char_has_prod->held_items[prod_index]);
+            lost = max(0, lost - 2);
+            use_item(manager, char_has_prod, char_has_prod->held_items[prod_index]);
         } else if (ch == '2') {
-            lost = min(0, lost - 1);
-            use_item(char_has_flashlight, char_has_flashlight->held_items[flashlight_index]);
+            lost = max(0, lost - 1);
+            use_item(manager, char_has_flashlight, char_has_flashlight->held_items[flashlight_index]);
         }
     }
 
     manager->morale -= lost;
 
     if (manager->morale <= 0) {
-        printf("[GAME OVER] - Morale dropped to 0\n");
-        exit(0);
+        game_print(manager, "[GAME OVER] - Morale dropped to 0\n");
+        end_game(manager, GAME_LOST_MORALE);
     }
 
     return lost;
@@ -840,48 +965,48 @@ int trigger_event(game_manager *manager, struct character *moved, room *motion_t
 {
     bool is_motion_tracker = motion_tracker_room != NULL;
     room *target_room = is_motion_tracker ? motion_tracker_room : moved->current_room;
-    if (target_room->has_event) {
-        int event_type = randint(1, 12);
-        target_room->has_event = false;
+    room_state *target_state = get_room_state(manager, target_room);
+    if (target_state->has_event) {
+        int event_type = randint(&manager->rng, 1, 12);
+        target_state->has_event = false;
 
         if (event_type <= 8) {
             if (is_motion_tracker) {
-                printf("All seems quiet...\n");
+                game_print(manager, "All seems quiet...\n");
             } else {
-                printf("[EVENT] - Safe\n");
+                game_print(manager, "[EVENT] - Safe\n");
             }
 
             return 0;
         } else if (event_type <= 10) {
             if (manager->jonesy_caught) {
                 if (is_motion_tracker) {
-                    printf("All seems quiet...\n");
+                    game_print(manager, "All seems quiet...\n");
                 } else {
-                    printf("[EVENT] - Safe\n");
+                    game_print(manager, "[EVENT] - Safe\n");
                 }
 
                 return 0;
             } else {
                 if (is_motion_tracker) {
-                    printf("Something tiny makes a blip. Probably Jonesy.\n");
+                    game_print(manager, "Something tiny makes a blip. Probably Jonesy.\n");
                 } else {
-                    printf("[EVENT] - Jonesy\n");
-                    printf("Jonesy hisses at you!\n");
+                    game_print(manager, "[EVENT] - Jonesy\n");
+                    game_print(manager, "Jonesy hisses at you!\n");
                 }
 
                 for (int i = 0; !is_motion_tracker && i < 3; i++) {
-                    if (moved->held_items[i] != NULL && moved->held_items[i]->type == CAT_CARRIER) {
-                        printf("%s has a CAT CARRIER - use it to catch Jonesy? (y/n) ", moved->last_name);
+                    if (moved->held_items[i] != NO_ITEM && get_item(manager, moved->held_items[i])->type == CAT_CARRIER) {
+                        game_print(manager, "%s has a CAT CARRIER - use it to catch Jonesy? (y/n) ", moved->last_name);
 
-                        char ch = '\0';
-                        while (ch != 'y' && ch != 'n') {
-                            ch = get_character();
-                        }
+                        char ch = get_choice(manager, DECISION_CONFIRM, "yn");
 
                         if (ch == 'y') {
-                            printf("%s used the CAT CARRIER to catch Jonesy.\n", moved->last_name);
+                            game_print(manager, "%s used the CAT CARRIER to catch Jonesy.\n", moved->last_name);
                             manager->jonesy_caught = true;
-                            moved->held_items[i] = NULL;
+                            free_item(manager, moved->held_items[i]);
+                            moved->held_items[i] = NO_ITEM;
+                            moved->num_items--;
                         }
                         break;
                     }
@@ -891,7 +1016,7 @@ int trigger_event(game_manager *manager, struct character *moved, room *motion_t
                     int dropped = reduce_morale(manager, 1, false);
 
                     if (dropped > 0) {
-                        printf("Morale decreases by %d.\n", dropped);
+                        game_print(manager, "Morale decreases by %d.\n", dropped);
                     }
                 }
             }
@@ -899,22 +1024,22 @@ int trigger_event(game_manager *manager, struct character *moved, room *motion_t
             return 1;
         } else {
             if (is_motion_tracker) {
-                printf("Something huge, and fast. Must be the Xenomorph.\n");
+                game_print(manager, "Something huge, and fast. Must be the Xenomorph.\n");
 
                 manager->xenomorph_location = target_room;
 
                 xeno_move(manager, 0, 2);
             } else {
-                printf("[EVENT] - Surprise Attack\n");
-                int lost_morale = randint(1, 2);
-                printf("You encounter the Xenomorph!\n");
+                game_print(manager, "[EVENT] - Surprise Attack\n");
+                int lost_morale = randint(&manager->rng, 1, 2);
+                game_print(manager, "You encounter the Xenomorph!\n");
 
                 manager->xenomorph_location = target_room;
 
                 int dropped = reduce_morale(manager, lost_morale, true);
 
                 if (dropped > 0) {
-                    printf("Morale decreases by %d.\n", dropped);
+                    game_print(manager, "Morale decreases by %d.\n", dropped);
                 }
 
                 flee(manager, moved);
@@ -933,32 +1058,31 @@ int trigger_event(game_manager *manager, struct character *moved, room *motion_t
  */
 void trigger_encounter(game_manager *manager)
 {
-    int discard_index = draw_encounter();
-    ENCOUNTER_TYPES encounter = discard_encounters[discard_index];
+    ENCOUNTER_TYPES encounter = draw_encounter(&manager->encounters, &manager->rng);
 
     // Check "Blow it out into space" final mission
     if (manager->final_mission_type == BLOW_IT_OUT_INTO_SPACE && encounter >= ALIEN_Lost_The_Signal &&
         encounter <= ALIEN_Hunt) {
         // Win if alien is in or adjacent to DOCKING BAY, a crew member is at AIRLOCK and another at BRIDGE,
         // and an alien is encountered
-        room *docking_bay = get_room(manager->game_map, "DOCKING BAY");
+        room *docking_bay = manager->game_map->docking_bay;
         if (docking_bay == NULL) {
             docking_bay = manager->game_map->player_start_room;
         }
 
-        room *airlock = get_room(manager->game_map, "AIRLOCK");
+        room *airlock = manager->game_map->airlock;
         if (airlock == NULL) {
             airlock = manager->game_map->ash_start_room;
         }
 
-        room *bridge = get_room(manager->game_map, "BRIDGE");
+        room *bridge = manager->game_map->bridge;
         if (bridge == NULL) {
             bridge = manager->game_map->xenomorph_start_room;
         }
 
         bool xeno_in_right_place = manager->xenomorph_location == docking_bay;
-        for (int i = 0; i < docking_bay->connection_count; i++) {
-            xeno_in_right_place |= manager->xenomorph_location == docking_bay->connections[i];
+        for (int i = 0; i < room_connection_count(manager->game_map, docking_bay); i++) {
+            xeno_in_right_place |= manager->xenomorph_location == room_connection(manager->game_map, docking_bay, i);
         }
 
         bool airlock_right_place = false;
@@ -981,25 +1105,26 @@ void trigger_encounter(game_manager *manager)
     case QUIET:;
         room *target_room =
             manager->game_map
-                ->rooms[manager->game_map->named_room_indices[randint(0, manager->game_map->named_room_count - 1)]];
-        printf("[ENCOUNTER] - All is quiet in %s. Xenomorph moves 1 space.", target_room->name);
+                ->rooms[manager->game_map->named_room_indices[randint(&manager->rng, 0, manager->game_map->named_room_count - 1)]];
+        game_print(manager, "[ENCOUNTER] - All is quiet in %s. Xenomorph moves 1 space.", target_room->name);
         if (manager->ash_location != NULL && !manager->ash_killed) {
-            printf(" Ash moves 1 space.\n");
+            game_print(manager, " Ash moves 1 space.\n");
         } else {
-            printf("\n");
+            game_print(manager, "\n");
         }
 
-        int scrap_decider = randint(1, 11);
+        room_state *target_state = get_room_state(manager, target_room);
+        int scrap_decider = randint(&manager->rng, 1, 11);
         if (scrap_decider <= 8) {
-            target_room->num_scrap += 2;
+            target_state->num_scrap += 2;
         } else if (scrap_decider <= 10) {
-            target_room->num_scrap += 3;
+            target_state->num_scrap += 3;
         } else {
-            target_room->num_scrap += 1;
+            target_state->num_scrap += 1;
         }
 
         if (manager->final_mission_type != CUT_OFF_EVERY_BULKHEAD_AND_VENT) {
-            target_room->has_event = true;
+            target_state->has_event = true;
         }
 
         xeno_move(manager, 1, 2);
@@ -1007,36 +1132,39 @@ void trigger_encounter(game_manager *manager)
 
         break;
     case ALIEN_Lost_The_Signal:
-        printf("[ENCOUNTER] - Lost the Signal - Xenomorph has returned to %s\n",
-               manager->game_map->xenomorph_start_room->name);
+        game_print(manager,
+                   "[ENCOUNTER] - Lost the Signal - Xenomorph has returned to %s\n",
+                   manager->game_map->xenomorph_start_room->name);
 
         manager->xenomorph_location = manager->game_map->xenomorph_start_room;
         xeno_move(manager, 0, 2);
         ash_move(manager, 1);
-        replace_alien_cards();
+        replace_alien_cards(&manager->encounters, &manager->rng);
 
         break;
     case ALIEN_Stalk:
-        printf("[ENCOUNTER] - The Xenomorph is stalking...\n");
+        game_print(manager, "[ENCOUNTER] - The Xenomorph is stalking...\n");
         xeno_move(manager, 3, 3);
         ash_move(manager, 1);
 
         break;
     case ALIEN_Hunt:
-        printf("[ENCOUNTER] - The Xenomorph is hunting!\n");
+        game_print(manager, "[ENCOUNTER] - The Xenomorph is hunting!\n");
         xeno_move(manager, 2, 4);
         ash_move(manager, 1);
 
         break;
     case ORDER937_Meet_Me_In_The_Infirmary:
         if (manager->ash_location != NULL && !manager->ash_killed) {
-            printf("[ENCOUNTER] - Meet Me in the Infirmary - Ash moves twice, and %s moves to %s\n",
-                   manager->active_character->last_name,
-                   manager->game_map->ash_start_room->name);
+            game_print(manager,
+                       "[ENCOUNTER] - Meet Me in the Infirmary - Ash moves twice, and %s moves to %s\n",
+                       manager->active_character->last_name,
+                       manager->game_map->ash_start_room->name);
         } else {
-            printf("[ENCOUNTER] - Meet Me in the Infirmary - %s moves to %s\n",
-                   manager->active_character->last_name,
-                   manager->game_map->ash_start_room->name);
+            game_print(manager,
+                       "[ENCOUNTER] - Meet Me in the Infirmary - %s moves to %s\n",
+                       manager->active_character->last_name,
+                       manager->game_map->ash_start_room->name);
         }
 
         manager->active_character->current_room = manager->game_map->ash_start_room;
@@ -1046,23 +1174,25 @@ void trigger_encounter(game_manager *manager)
         break;
     case ORDER937_Crew_Expendable:
         if (manager->ash_location != NULL && !manager->ash_killed) {
-            printf("[ENCOUNTER] - Crew Expendable - Ash moves twice, and %s loses all Scrap\n",
-                   manager->active_character->last_name);
+            game_print(manager,
+                       "[ENCOUNTER] - Crew Expendable - Ash moves twice, and %s loses all Scrap\n",
+                       manager->active_character->last_name);
         } else {
-            printf("[ENCOUNTER] - Crew Expendable - %s loses all Scrap\n", manager->active_character->last_name);
+            game_print(manager, "[ENCOUNTER] - Crew Expendable - %s loses all Scrap\n", manager->active_character->last_name);
         }
 
-        replace_order937_cards();
+        replace_order937_cards(&manager->encounters, &manager->rng);
         ash_move(manager, 2);
         manager->active_character->num_scrap = 0;
 
         break;
     case ORDER937_Collating_Data:
         if (manager->ash_location != NULL && !manager->ash_killed) {
-            printf("[ENCOUNTER] - Collating Data - Ash moves twice, and each character loses 1 "
-                   "Scrap\n");
+            game_print(manager,
+                       "[ENCOUNTER] - Collating Data - Ash moves twice, and each character loses 1 "
+                       "Scrap\n");
         } else {
-            printf("[ENCOUNTER] - Collating Data - Each character loses 1 Scrap\n");
+            game_print(manager, "[ENCOUNTER] - Collating Data - Each character loses 1 Scrap\n");
         }
 
         for (int i = 0; i < manager->character_count; i++) {
@@ -1072,7 +1202,7 @@ void trigger_encounter(game_manager *manager)
 
         break;
     default:
-        printf("[ERROR] - Unknown encounter type %d\n", encounter);
+        game_print(manager, "[ERROR] - Unknown encounter type %d\n", encounter);
         break;
     }
 }
@@ -1084,12 +1214,15 @@ void trigger_encounter(game_manager *manager)
  */
 void flee(game_manager *manager, struct character *moved)
 {
-    printf("%s must flee 3 spaces:\n", moved->last_name);
+    game_print(manager, "%s must flee 3 spaces:\n", moved->last_name);
 
-    room_queue *allowed_moves = find_rooms_by_distance(manager->game_map, moved->current_room, 3, false);
-    moved->current_room = character_move(manager, moved, allowed_moves, false);
+    int num_allowed_moves =
+        find_rooms_by_distance(manager->game_map, moved->current_room, 3, false, manager->scratch);
+    // The character stays put if there's nowhere to flee to
+    if (num_allowed_moves > 0) {
+        moved->current_room = character_move(manager, moved, manager->scratch->results, num_allowed_moves, false);
+    }
     update_objectives(manager);
-    free(allowed_moves);
 }
 
 /**
@@ -1100,44 +1233,41 @@ void flee(game_manager *manager, struct character *moved)
 bool pickup(game_manager *manager)
 {
     bool break_loop = false;
+    room_state *here = get_room_state(manager, manager->active_character->current_room);
 
-    if (manager->active_character->current_room->num_scrap == 0 &&
-        manager->active_character->current_room->num_items == 0) {
-        printf("There are no items or Scrap to pick up.\n");
+    if (here->num_scrap == 0 &&
+        here->num_items == 0) {
+        game_print(manager, "There are no items or Scrap to pick up.\n");
     } else {
         // Print out options
-        printf("Pick up options:\n");
+        game_print(manager, "Pick up options:\n");
         int option_index = 0;
 
         // Print scrap
         int scrap_index = -1;
-        if (manager->active_character->current_room->num_scrap != 0) {
+        if (here->num_scrap != 0) {
             scrap_index = option_index;
-            printf("\t%d) Scrap (%d)\n", ++option_index, manager->active_character->current_room->num_scrap);
+            option_index++;
+            game_print(manager, "\t%d) Scrap (%d)\n", option_index, here->num_scrap);
         }
 
         // Print room items
         int item_indices[NUM_ROOM_ITEMS] = {-1, -1, -1, -1, -1, -1};
-        for (int k = 0; k < manager->active_character->current_room->num_items; k++) {
-            if (manager->active_character->current_room->room_items[k] != NULL) {
+        for (int k = 0; k < NUM_ROOM_ITEMS; k++) {
+            if (here->room_items[k] != NO_ITEM) {
                 item_indices[k] = option_index;
-                printf("\t%d) ", ++option_index);
-                print_item(manager->active_character->current_room->room_items[k]);
+                option_index++;
+                game_print(manager, "\t%d) ", option_index);
+                print_item(manager->output, get_item(manager, here->room_items[k]));
             }
         }
 
         // Back
-        printf("\tb) Back\n");
+        game_print(manager, "\tb) Back\n");
 
         // Read input
-        char ch = '\0';
-        while (ch < '1' || ch > '0' + option_index) {
-            ch = get_character();
-
-            if (ch == 'b') {
-                break;
-            }
-        }
+        char options[12];
+        char ch = get_choice(manager, DECISION_ITEM, menu_options(options, option_index, "b"));
 
         // Process input
         if (ch == 'b') {
@@ -1146,58 +1276,58 @@ bool pickup(game_manager *manager)
             int selection_index = ch - '0' - 1;
 
             if (scrap_index == selection_index) {
-                printf("Pick up how much scrap? (Max %d): ", manager->active_character->current_room->num_scrap);
+                int max_scrap = min(9, here->num_scrap);
+                game_print(manager, "Pick up how much scrap? (Max %d): ", max_scrap);
 
-                ch = '\0';
-                while (ch < '1' || ch > '0' + manager->active_character->current_room->num_scrap) {
-                    ch = get_character();
-                }
+                ch = get_choice(manager, DECISION_AMOUNT, menu_options(options, max_scrap, ""));
 
-                printf("%s picked up %d Scrap\n", manager->active_character->last_name, ch - '0');
-                manager->active_character->current_room->num_scrap -= ch - '0';
+                game_print(manager, "%s picked up %d Scrap\n", manager->active_character->last_name, ch - '0');
+                here->num_scrap -= ch - '0';
                 manager->active_character->num_scrap += ch - '0';
                 manager->active_character->num_scrap = min(9, manager->active_character->num_scrap);
 
                 break_loop = true;
             } else {
-                item *target_item = NULL;
+                item_id target_item = NO_ITEM;
                 int m;
                 for (m = 0; m < NUM_ROOM_ITEMS; m++) {
                     if (item_indices[m] == selection_index) {
-                        target_item = manager->active_character->current_room->room_items[m];
+                        target_item = here->room_items[m];
                         break;
                     }
                 }
 
-                if (target_item->type == COOLANT_CANISTER) {
-                    if (manager->active_character->coolant == NULL) {
-                        printf("%s picked up the COOLANT CANISTER\n", manager->active_character->last_name);
-                        manager->active_character->current_room->room_items[m] = NULL;
+                if (get_item(manager, target_item)->type == COOLANT_CANISTER) {
+                    if (manager->active_character->coolant == NO_ITEM) {
+                        game_print(manager, "%s picked up the COOLANT CANISTER\n", manager->active_character->last_name);
+                        here->room_items[m] = NO_ITEM;
+                        here->num_items--;
                         manager->active_character->coolant = target_item;
                         break_loop = true;
                     } else {
-                        printf("%s is already holding a COOLANT CANISTER\n", manager->active_character->last_name);
+                        game_print(manager, "%s is already holding a COOLANT CANISTER\n", manager->active_character->last_name);
                     }
                 } else {
                     if (manager->active_character->num_items < 3) {
                         for (int l = 0; l < 3; l++) {
-                            if (manager->active_character->held_items[l] == NULL) {
+                            if (manager->active_character->held_items[l] == NO_ITEM) {
                                 manager->active_character->held_items[l] = target_item;
                                 break;
                             }
                         }
                         manager->active_character->num_items++;
 
-                        printf("%s picked up the %s\n",
-                               manager->active_character->last_name,
-                               item_names[manager->active_character->current_room->room_items[m]->type]);
+                        game_print(manager,
+                                   "%s picked up the %s\n",
+                                   manager->active_character->last_name,
+                                   item_names[get_item(manager, here->room_items[m])->type]);
 
-                        manager->active_character->current_room->num_items--;
-                        manager->active_character->current_room->room_items[m] = NULL;
+                        here->num_items--;
+                        here->room_items[m] = NO_ITEM;
 
                         break_loop = true;
                     } else {
-                        printf("%s is already holding 3 items\n", manager->active_character->last_name);
+                        game_print(manager, "%s is already holding 3 items\n", manager->active_character->last_name);
                     }
                 }
             }
@@ -1215,52 +1345,50 @@ bool pickup(game_manager *manager)
 bool drop(game_manager *manager)
 {
     bool break_loop = false;
+    room_state *here = get_room_state(manager, manager->active_character->current_room);
 
     if (manager->active_character->num_scrap == 0 && manager->active_character->num_items == 0 &&
-        manager->active_character->coolant == NULL) {
-        printf("%s has no items or Scrap to drop.\n", manager->active_character->last_name);
+        manager->active_character->coolant == NO_ITEM) {
+        game_print(manager, "%s has no items or Scrap to drop.\n", manager->active_character->last_name);
     } else {
         // Print out options
-        printf("Drop options:\n");
+        game_print(manager, "Drop options:\n");
         int option_index = 0;
 
         // Print scrap
         int scrap_index = -1;
         if (manager->active_character->num_scrap != 0) {
             scrap_index = option_index;
-            printf("\t%d) Scrap (%d)\n", ++option_index, manager->active_character->num_scrap);
+            option_index++;
+            game_print(manager, "\t%d) Scrap (%d)\n", option_index, manager->active_character->num_scrap);
         }
 
         // Print character items
         int item_indices[3] = {-1, -1, -1};
         for (int k = 0; k < 3; k++) {
-            if (manager->active_character->held_items[k] != NULL) {
+            if (manager->active_character->held_items[k] != NO_ITEM) {
                 item_indices[k] = option_index;
-                printf("\t%d) ", ++option_index);
-                print_item(manager->active_character->held_items[k]);
+                option_index++;
+                game_print(manager, "\t%d) ", option_index);
+                print_item(manager->output, get_item(manager, manager->active_character->held_items[k]));
             }
         }
 
         // Coolant
         int coolant_index = -1;
-        if (manager->active_character->coolant != NULL) {
+        if (manager->active_character->coolant != NO_ITEM) {
             coolant_index = option_index;
-            printf("\t%d) ", ++option_index);
-            print_item(manager->active_character->coolant);
+            option_index++;
+            game_print(manager, "\t%d) ", option_index);
+            print_item(manager->output, get_item(manager, manager->active_character->coolant));
         }
 
         // Back
-        printf("\tb) Back\n");
+        game_print(manager, "\tb) Back\n");
 
         // Read input
-        char ch = '\0';
-        while (ch < '1' || ch > '0' + option_index) {
-            ch = get_character();
-
-            if (ch == 'b') {
-                break;
-            }
-        }
+        char options[12];
+        char ch = get_choice(manager, DECISION_ITEM, menu_options(options, option_index, "b"));
 
         // Process input
         if (ch == 'b') {
@@ -1269,20 +1397,17 @@ bool drop(game_manager *manager)
             int selection_index = ch - '0' - 1;
 
             if (scrap_index == selection_index) {
-                printf("Drop how much scrap? (Max %d): ", manager->active_character->num_scrap);
+                game_print(manager, "Drop how much scrap? (Max %d): ", manager->active_character->num_scrap);
 
-                ch = '\0';
-                while (ch < '1' || ch > '0' + manager->active_character->num_scrap) {
-                    ch = get_character();
-                }
+                ch = get_choice(manager, DECISION_AMOUNT, menu_options(options, manager->active_character->num_scrap, ""));
 
-                printf("%s dropped %d Scrap\n", manager->active_character->last_name, ch - '0');
-                manager->active_character->current_room->num_scrap += ch - '0';
+                game_print(manager, "%s dropped %d Scrap\n", manager->active_character->last_name, ch - '0');
+                here->num_scrap += ch - '0';
                 manager->active_character->num_scrap -= ch - '0';
 
                 break_loop = true;
-            } else if (manager->active_character->current_room->num_items < NUM_ROOM_ITEMS) {
-                item *target_item = NULL;
+            } else if (here->num_items < NUM_ROOM_ITEMS) {
+                item_id target_item = NO_ITEM;
                 int k;
                 for (k = 0; k < 3; k++) {
                     if (item_indices[k] == selection_index) {
@@ -1292,43 +1417,45 @@ bool drop(game_manager *manager)
                 }
 
                 if (selection_index == coolant_index) {
-                    printf("%s dropped a COOLANT CANISTER in %s\n",
-                           manager->active_character->last_name,
-                           manager->active_character->current_room->name);
+                    game_print(manager,
+                               "%s dropped a COOLANT CANISTER in %s\n",
+                               manager->active_character->last_name,
+                               manager->active_character->current_room->name);
 
                     for (int m = 0; m < NUM_ROOM_ITEMS; m++) {
-                        if (manager->active_character->current_room->room_items[m] == NULL) {
-                            manager->active_character->current_room->room_items[m] = manager->active_character->coolant;
+                        if (here->room_items[m] == NO_ITEM) {
+                            here->room_items[m] = manager->active_character->coolant;
                             break;
                         }
                     }
 
-                    manager->active_character->coolant = NULL;
-                    manager->active_character->current_room->num_items++;
+                    manager->active_character->coolant = NO_ITEM;
+                    here->num_items++;
 
                     break_loop = true;
                 } else {
-                    printf("%s dropped a %s in %s\n",
-                           manager->active_character->last_name,
-                           item_names[target_item->type],
-                           manager->active_character->current_room->name);
+                    game_print(manager,
+                               "%s dropped a %s in %s\n",
+                               manager->active_character->last_name,
+                               item_names[get_item(manager, target_item)->type],
+                               manager->active_character->current_room->name);
 
                     for (int l = 0; l < NUM_ROOM_ITEMS; l++) {
-                        if (manager->active_character->current_room->room_items[l] == NULL) {
-                            manager->active_character->current_room->room_items[l] =
+                        if (here->room_items[l] == NO_ITEM) {
+                            here->room_items[l] =
                                 manager->active_character->held_items[k];
                             break;
                         }
                     }
-                    manager->active_character->current_room->num_items++;
+                    here->num_items++;
                     manager->active_character->num_items--;
 
-                    manager->active_character->held_items[k] = NULL;
+                    manager->active_character->held_items[k] = NO_ITEM;
 
                     break_loop = true;
                 }
             } else {
-                printf("%s already has %d items\n", manager->active_character->current_room->name, NUM_ROOM_ITEMS);
+                game_print(manager, "%s already has %d items\n", manager->active_character->current_room->name, NUM_ROOM_ITEMS);
             }
         }
     }
@@ -1348,138 +1475,121 @@ int use(game_manager *manager)
     int usable_indices[3];
     int num_usable = 0;
     for (int i = 0; i < 3; i++) {
-        if (manager->active_character->held_items[i] != NULL && manager->active_character->held_items[i]->uses_action) {
+        if (manager->active_character->held_items[i] != NO_ITEM && get_item(manager, manager->active_character->held_items[i])->uses_action) {
             usable_indices[num_usable++] = i;
         }
     }
 
     if (num_usable == 0) {
-        printf("%s has no items that can be used.\n", manager->active_character->last_name);
+        game_print(manager, "%s has no items that can be used.\n", manager->active_character->last_name);
         return 0;
     } else {
-        printf("Use options:\n");
+        game_print(manager, "Use options:\n");
 
         for (int i = 0; i < num_usable; i++) {
-            printf("\t%d) ", i + 1);
-            print_item(manager->active_character->held_items[usable_indices[i]]);
+            game_print(manager, "\t%d) ", i + 1);
+            print_item(manager->output, get_item(manager, manager->active_character->held_items[usable_indices[i]]));
         }
-        printf("\tb) Back\n");
+        game_print(manager, "\tb) Back\n");
 
-        char ch = '\0';
-        while (ch < '1' || ch > '0' + num_usable) {
-            ch = get_character();
-
-            if (ch == 'b') {
-                break;
-            }
-        }
+        char options[11];
+        char ch = get_choice(manager, DECISION_ITEM, menu_options(options, num_usable, "b"));
 
         if (ch == 'b') {
             return 0;
         } else {
             int item_selection = ch - '0' - 1;
 
-            ITEM_TYPES item_type = manager->active_character->held_items[usable_indices[item_selection]]->type;
+            ITEM_TYPES item_type = get_item(manager, manager->active_character->held_items[usable_indices[item_selection]])->type;
 
             switch (item_type) {
             case MOTION_TRACKER:;
-                room_queue *within_2 =
-                    find_rooms_by_distance(manager->game_map, manager->active_character->current_room, 2, true);
+                int num_within_2 = find_rooms_by_distance(
+                    manager->game_map, manager->active_character->current_room, 2, true, manager->scratch);
 
-                int event_rooms[64];
+                // Filter the results in place, keeping their order
+                room **event_rooms = manager->scratch->results;
                 int num_event_rooms = 0;
-                for (int i = 0; i < within_2->size; i++) {
-                    if (poll_position(within_2, i) != manager->active_character->current_room &&
-                        poll_position(within_2, i)->has_event) {
-                        event_rooms[num_event_rooms++] = i;
+                for (int i = 0; i < num_within_2; i++) {
+                    room *nearby = manager->scratch->results[i];
+                    if (nearby != manager->active_character->current_room && get_room_state(manager, nearby)->has_event) {
+                        event_rooms[num_event_rooms++] = nearby;
                     }
                 }
 
+                num_event_rooms = min(num_event_rooms, 9);
                 if (num_event_rooms == 0) {
-                    printf("There are no rooms with events nearby.\n");
+                    game_print(manager, "There are no rooms with events nearby.\n");
                 } else {
-                    printf("Choose a room to check events:\n");
+                    game_print(manager, "Choose a room to check events:\n");
                     for (int i = 0; i < num_event_rooms; i++) {
-                        printf("\t%d) %s\n", i + 1, poll_position(within_2, event_rooms[i])->name);
+                        game_print(manager, "\t%d) %s\n", i + 1, event_rooms[i]->name);
                     }
-                    printf("\tb) Back\n");
+                    game_print(manager, "\tb) Back\n");
 
-                    ch = '\0';
-                    while (ch < '1' || ch > '0' + num_event_rooms) {
-                        ch = get_character();
-
-                        if (ch == 'b') {
-                            break;
-                        }
-                    }
+                    ch = get_choice(manager, DECISION_TARGET_ROOM, menu_options(options, num_event_rooms, "b"));
 
                     if (ch == 'b') {
-                        free(within_2);
                         return 0;
                     } else {
                         ch = ch - '0' - 1;
-                        use_item(manager->active_character, manager->active_character->held_items[item_selection]);
-                        trigger_event(manager, manager->active_character, poll_position(within_2, event_rooms[ch]));
+                        use_item(manager,
+                                 manager->active_character,
+                                 manager->active_character->held_items[usable_indices[item_selection]]);
+                        trigger_event(manager, manager->active_character, event_rooms[ch]);
 
                         break_loop = 1;
                     }
                 }
-                free(within_2);
                 break;
-            case GRAPPLE_GUN:;
-                room_queue *grapple_q = shortest_path(
-                    manager->game_map, manager->xenomorph_location, manager->active_character->current_room);
-                if (grapple_q->size > 4) {
-                    printf("The Xenomorph is not within 3 spaces.\n");
-                    free(grapple_q);
+            case GRAPPLE_GUN:
+                if (room_distance(manager->game_map,
+                                  manager->xenomorph_location,
+                                  manager->active_character->current_room,
+                                  manager->scratch) > 3) {
+                    game_print(manager, "The Xenomorph is not within 3 spaces.\n");
                     return 0;
                 } else {
-                    free(grapple_q);
-                    room_queue *alien_locations =
-                        find_rooms_by_distance(manager->game_map, manager->xenomorph_location, 3, false);
-
-                    printf("Where to send the Xenomorph to?\n");
-                    for (int i = 0; i < alien_locations->size; i++) {
-                        printf("\t%d) %s\n", i + 1, poll_position(alien_locations, i)->name);
+                    int num_alien_locations = find_rooms_by_distance(
+                        manager->game_map, manager->xenomorph_location, 3, false, manager->scratch);
+                    num_alien_locations = min(num_alien_locations, 9);
+                    room **alien_locations = manager->scratch->results;
+
+                    game_print(manager, "Where to send the Xenomorph to?\n");
+                    for (int i = 0; i < num_alien_locations; i++) {
+                        game_print(manager, "\t%d) %s\n", i + 1, alien_locations[i]->name);
                     }
-                    printf("\tb) Back\n");
+                    game_print(manager, "\tb) Back\n");
 
-                    ch = '\0';
-                    while (ch < '1' || ch > '0' + alien_locations->size) {
-                        ch = get_character();
-
-                        if (ch == 'b') {
-                            break;
-                        }
-                    }
+                    ch = get_choice(manager, DECISION_TARGET_ROOM, menu_options(options, num_alien_locations, "b"));
 
                     if (ch == 'b') {
-                        free(alien_locations);
                         return 0;
                     } else {
                         ch = ch - '0' - 1;
-                        use_item(manager->active_character, manager->active_character->held_items[item_selection]);
-                        printf("The Xenomorph retreats to %s!\n", poll_position(alien_locations, ch)->name);
-                        manager->xenomorph_location = poll_position(alien_locations, ch);
+                        use_item(manager,
+                                 manager->active_character,
+                                 manager->active_character->held_items[usable_indices[item_selection]]);
+                        game_print(manager, "The Xenomorph retreats to %s!\n", alien_locations[ch]->name);
+                        manager->xenomorph_location = alien_locations[ch];
                     }
-                    free(alien_locations);
                     break_loop = 1;
                 }
                 break;
-            case INCINERATOR:;
-                room_queue *incinerator_q = shortest_path(
-                    manager->game_map, manager->xenomorph_location, manager->active_character->current_room);
-                if (incinerator_q->size > 4) {
-                    printf("The Xenomorph is not within 3 spaces.\n");
-                    free(incinerator_q);
+            case INCINERATOR:
+                if (room_distance(manager->game_map,
+                                  manager->xenomorph_location,
+                                  manager->active_character->current_room,
+                                  manager->scratch) > 3) {
+                    game_print(manager, "The Xenomorph is not within 3 spaces.\n");
                     return 0;
                 } else {
-                    use_item(manager->active_character, manager->active_character->held_items[item_selection]);
-                    printf("The Xenomorph retreats to %s!\n", manager->game_map->xenomorph_start_room->name);
+                    use_item(manager,
+                             manager->active_character,
+                             manager->active_character->held_items[usable_indices[item_selection]]);
+                    game_print(manager, "The Xenomorph retreats to %s!\n", manager->game_map->xenomorph_start_room->name);
                     manager->xenomorph_location = manager->game_map->xenomorph_start_room;
 
-                    free(incinerator_q);
-
                     // Check "You Have My Sympathies" final mission
                     if (manager->is_final_mission && manager->final_mission_type == YOU_HAVE_MY_SYMPATHIES &&
                         manager->ash_killed) {
@@ -1498,121 +1608,185 @@ int use(game_manager *manager)
 }
 
 /**
- * Main game loop, handles player input and game logic
+ * Save handler, writes the game to the manager's save file
  * @param manager  Game manager
  */
-void game_loop(game_manager *manager)
+void save_game(game_manager *manager)
 {
-    printf("--------------SITUATION CRITICAL---------------\n");
-    printf("--------REPORT ISSUED BY DALLAS, ARTHUR--------\n");
-    printf("An Alien is stalking us on board the           \n");
-    printf("Nostromo, and Executive Officer Kane is        \n");
-    printf("dead. The remaining crew and I are working     \n");
-    printf("together to patch the ship and do what we      \n");
-    printf("can to survive. I don't know if we'll make     \n");
-    printf("it. The Alien is big, fast, and deadly, and    \n");
-    printf("could be waiting just beyond the next hatch... \n");
-    printf("-----------------------------------------------\n");
-    print_game_objectives(manager);
-
-    printf("Enter to start\n");
-    get_character();
+    game_state *state = new_game_state(manager->game_map);
+    capture_game_state(manager, state);
 
-    while (1) {
-        printf("-----Round %d-----\n", manager->round_index);
+    map_error error;
+    if (save_game_state(state, manager->game_map, manager->save_file, &error)) {
+        game_print(manager, "Saved the game to %s\n", manager->save_file);
+    } else {
+        game_print(manager, "[ERROR] - %s: %s\n", manager->save_file, error.message);
+    }
 
-        for (int i = 0; i < 5; i++) {
-            if (manager->characters[i] == NULL) {
-                break;
+    free(state);
+}
+
+/**
+ * Load handler, replaces the game with the one in the manager's save file and resumes it from its action
+ * menu. Only returns if the save file can't be loaded
+ * @param manager  Game manager, in game_loop
+ */
+void load_game(game_manager *manager)
+{
+    map_error error;
+    game_state *state = load_game_state(manager->save_file, manager->game_map, &error);
+    if (state == NULL) {
+        game_print(manager, "[ERROR] - %s: %s\n", manager->save_file, error.message);
+        return;
+    }
+
+    restore_game_state(manager, state);
+    free(state);
+
+    game_print(manager, "Loaded the game from %s\n", manager->save_file);
+    longjmp(*manager->end_of_game, GAME_LOADED_JUMP);
+}
+
+/**
+ * Play rounds until end_game is called, handling player input and game logic
+ * @param manager  Game manager
+ */
+void _play_rounds(game_manager *manager)
+{
+    // Games restored mid-way resume where they left off instead of starting over
+    if (manager->round_index == 1 && manager->turn_index == 0 && !manager->turn_in_progress) {
+        game_print(manager, "--------------SITUATION CRITICAL---------------\n");
+        game_print(manager, "--------REPORT ISSUED BY DALLAS, ARTHUR--------\n");
+        game_print(manager, "An Alien is stalking us on board the           \n");
+        game_print(manager, "Nostromo, and Executive Officer Kane is        \n");
+        game_print(manager, "dead. The remaining crew and I are working     \n");
+        game_print(manager, "together to patch the ship and do what we      \n");
+        game_print(manager, "can to survive. I don't know if we'll make     \n");
+        game_print(manager, "it. The Alien is big, fast, and deadly, and    \n");
+        game_print(manager, "could be waiting just beyond the next hatch... \n");
+        game_print(manager, "-----------------------------------------------\n");
+        print_game_objectives(manager);
+
+        game_print(manager, "Enter to start\n");
+        manager->input->choose(manager->input, manager, DECISION_START_GAME, "\n");
+    }
+
+    while (1) {
+        if (manager->turn_index == 0 && !manager->turn_in_progress) {
+            if (manager->round_index <= manager->morale_history_length) {
+                manager->morale_history[manager->round_index - 1] = manager->morale;
             }
 
+            game_print(manager, "-----Round %d-----\n", manager->round_index);
+        }
+
+        for (int i = manager->turn_index; i < manager->character_count; i++) {
             manager->turn_index = i;
 
             manager->active_character = manager->characters[manager->turn_index];
             character *active = manager->active_character;
-            printf("------Turn %d: %s------\n", manager->turn_index + 1, active->last_name);
 
-            if (active->self_destruct_tracker > 0) {
-                active->self_destruct_tracker--;
+            if (!manager->turn_in_progress) {
+                game_print(manager, "------Turn %d: %s------\n", manager->turn_index + 1, active->last_name);
 
-                if (active->self_destruct_tracker <= 0) {
-                    printf("[SELF-DESTRUCT] The Self-Destruct timer drops to 0!\n");
-                    printf("[GAME OVER] - The Nostromo self-destructed with the Crew still on it!\n");
-                    exit(0);
-                } else {
-                    printf("[SELF-DESTRUCT] The Self-Destruct timer drops to %d!\n", active->self_destruct_tracker);
+                if (active->self_destruct_tracker > 0) {
+                    active->self_destruct_tracker--;
+
+                    if (active->self_destruct_tracker <= 0) {
+                        game_print(manager, "[SELF-DESTRUCT] The Self-Destruct timer drops to 0!\n");
+                        game_print(manager, "[GAME OVER] - The Nostromo self-destructed with the Crew still on it!\n");
+                        end_game(manager, GAME_LOST_SELF_DESTRUCT);
+                    } else {
+                        game_print(manager,
+                                   "[SELF-DESTRUCT] The Self-Destruct timer drops to %d!\n",
+                                   active->self_destruct_tracker);
+                    }
                 }
-            }
 
-            // Some abilities can only be used once per turn
-            bool used_ability = false;
+                // Some abilities can only be used once per turn
+                manager->used_ability = false;
 
-            printf("h - view help menu\n");
+                game_print(manager, "h - view help menu\n");
 
-            bool do_encounter = true;
-            for (int j = active->max_actions; j > 0; j--) {
-                active->current_actions = j;
+                manager->do_encounter = true;
+                active->current_actions = active->max_actions;
+                manager->turn_in_progress = true;
+            }
+
+            for (; active->current_actions > 0; active->current_actions--) {
 
                 char choice = '\0';
                 while (1) {
+                    // Nothing allocated while answering the last action menu is used anymore
+                    reset_arena(&manager->turn_scratch, 0);
 
-                    printf("Actions - %d/%d\n", active->current_actions, active->max_actions);
+                    game_print(manager, "Actions - %d/%d\n", active->current_actions, active->max_actions);
 
-                    choice = get_character();
+                    // Unlike other menus, the action menu reports unrecognized commands
+                    choice = manager->input->choose(manager->input,
+                                                    manager,
+                                                    DECISION_ACTION,
+                                                    manager->final_mission_type == BLOW_IT_OUT_INTO_SPACE
+                                                        ? "hmpdaikcugsvlonqrwfe"
+                                                        : "hmpdaikcugsvloqrwfe");
 
                     bool break_loop = false;
                     bool recognized = true;
 
                     switch (choice) {
                     case 'h':
-                        printf("m - move\n"
-                               "p - pick up\n"
-                               "d - drop\n"
-                               "a - ability\n"
-                               "i - view inventory\n"
-                               "k - view team info\n"
-                               "c - craft\n"
-                               "u - use item\n"
-                               "g - give item\n"
-                               "s - end turn early\n"
-                               "v - view current room\n"
-                               "l - character locations\n"
-                               "%s"
-                               "%s"
-                               "q - draw map\n"
-                               "r - print text map\n"
-                               "e - exit\n",
-                               manager->is_final_mission ? "o - print final objective\n"
-                                                         : "o - print game objectives\n",
-                               manager->final_mission_type == BLOW_IT_OUT_INTO_SPACE
-                                   ? "n - discard scrap, view next encounter\n"
-                                   : "");
+                        game_print(manager,
+                                   "m - move\n"
+                                   "p - pick up\n"
+                                   "d - drop\n"
+                                   "a - ability\n"
+                                   "i - view inventory\n"
+                                   "k - view team info\n"
+                                   "c - craft\n"
+                                   "u - use item\n"
+                                   "g - give item\n"
+                                   "s - end turn early\n"
+                                   "v - view current room\n"
+                                   "l - character locations\n"
+                                   "%s"
+                                   "%s"
+                                   "q - draw map\n"
+                                   "r - print text map\n"
+                                   "w - save game\n"
+                                   "f - load saved game\n"
+                                   "e - exit\n",
+                                   manager->is_final_mission ? "o - print final objective\n"
+                                                             : "o - print game objectives\n",
+                                   manager->final_mission_type == BLOW_IT_OUT_INTO_SPACE
+                                       ? "n - discard scrap, view next encounter\n"
+                                       : "");
 
                         break;
                     case 'm':; // Start case with assignment
                         room *last_room = active->current_room;
-                        active->current_room = character_move(manager, active, NULL, true);
+                        active->current_room = character_move(manager, active, NULL, 0, true);
                         if (active->current_room == last_room) {
                             // Move canceled
-                            printf("Canceled move\n");
+                            game_print(manager, "Canceled move\n");
                         } else {
                             // Move successful
-                            printf("%s moved from %s to %s\n",
-                                   active->last_name,
-                                   last_room->name,
-                                   active->current_room->name);
+                            game_print(manager,
+                                       "%s moved from %s to %s\n",
+                                       active->last_name,
+                                       last_room->name,
+                                       active->current_room->name);
 
                             // Check for events in new location
                             if (trigger_event(manager, active, NULL) == 2) { // Alien encounter
                                 // Immediately end turn and don't do an encounter
-                                j = 0;
-                                do_encounter = false;
+                                active->current_actions = 0;
+                                manager->do_encounter = false;
                             }
 
                             // Check if player moved into xeno area
                             if (xeno_move(manager, 0, 2)) {
-                                j = 0;
-                                do_encounter = false;
+                                active->current_actions = 0;
+                                manager->do_encounter = false;
                             }
 
                             // Check if player moved into ash area
@@ -1634,53 +1808,52 @@ void game_loop(game_manager *manager)
                         update_final_mission(manager);
                         break;
                     case 'a':
-                        if (!used_ability) {
-                            printf("Using %s's ability: %s\n", active->last_name, active->ability_description);
-                            ability_output *ao =
-                                active->ability_function(manager->game_map, manager->characters, active);
+                        if (!manager->used_ability) {
+                            game_print(manager, "Using %s's ability: %s\n", active->last_name, active->ability_description);
+                            ability_output *ao = active->ability_function(manager, active);
 
                             break_loop = ao->use_action;
-                            used_ability = !ao->can_use_ability_again;
-
-                            if (ao->move_character_index >= 0) {
-                                room *last_room = manager->characters[ao->move_character_index]->current_room;
-                                manager->characters[ao->move_character_index]->current_room =
-                                    character_move(manager, manager->characters[ao->move_character_index], NULL, false);
-                                printf("%s moved %s from %s to %s\n",
-                                       active->last_name,
-                                       manager->characters[ao->move_character_index]->last_name,
-                                       last_room->name,
-                                       manager->characters[ao->move_character_index]->current_room->name);
+                            manager->used_ability = !ao->can_use_ability_again;
+                            int move_index = ao->move_character_index;
+
+                            if (move_index >= 0) {
+                                room *last_room = manager->characters[move_index]->current_room;
+                                manager->characters[move_index]->current_room =
+                                    character_move(manager, manager->characters[move_index], NULL, 0, false);
+                                game_print(manager,
+                                           "%s moved %s from %s to %s\n",
+                                           active->last_name,
+                                           manager->characters[move_index]->last_name,
+                                           last_room->name,
+                                           manager->characters[move_index]->current_room->name);
                             }
-
-                            free(ao);
                         } else {
-                            printf("You may only use this ability once per turn.\n");
+                            game_print(manager, "You may only use this ability once per turn.\n");
                         }
 
                         break;
                     case 'i':
-                        print_inventory(active);
+                        print_inventory(manager, active);
 
                         break;
                     case 'k':
-                        printf("Team Morale: %d\n", manager->morale);
+                        game_print(manager, "Team Morale: %d\n", manager->morale);
                         for (int m = 0; m < manager->character_count; m++) {
-                            print_inventory(manager->characters[m]);
+                            print_inventory(manager, manager->characters[m]);
                         }
                         break;
                     case 'c':
                         if (active->num_scrap == 0) {
-                            printf("%s has no Scrap\n", active->last_name);
+                            game_print(manager, "%s has no Scrap\n", active->last_name);
 
                             break;
                         } else if (active->num_items == 3) {
-                            printf("%s already has 3 items\n", active->last_name);
+                            game_print(manager, "%s already has 3 items\n", active->last_name);
 
                             break;
                         }
 
-                        printf("Craft Options:\n");
+                        game_print(manager, "Craft Options:\n");
 
                         bool is_brett = active->ability_function == brett_ability;
 
@@ -1694,22 +1867,16 @@ void game_loop(game_manager *manager)
                                 cost -= cost_reduction;
                             }
 
-                            if (cost <= active->num_scrap && m != COOLANT_CANISTER) {
+                            if (cost <= active->num_scrap && m != COOLANT_CANISTER && num_craftable < 9) {
                                 craftable_indices[num_craftable++] = m;
-                                printf("\t%d) ", num_craftable);
-                                print_item_type(m, cost >= 2 ? cost_reduction : 0);
+                                game_print(manager, "\t%d) ", num_craftable);
+                                print_item_type(manager->output, m, cost >= 2 ? cost_reduction : 0);
                             }
                         }
-                        printf("\tb) Back\n");
+                        game_print(manager, "\tb) Back\n");
 
-                        char ch = '\0';
-                        while (ch < '1' || ch > '0' + num_craftable) {
-                            ch = get_character();
-
-                            if (ch == 'b') {
-                                break;
-                            }
-                        }
+                        char options[11];
+                        char ch = get_choice(manager, DECISION_ITEM, menu_options(options, num_craftable, "b"));
 
                         if (ch == 'b') {
                             break;
@@ -1717,12 +1884,12 @@ void game_loop(game_manager *manager)
                             ch = ch - '0' - 1;
                             ch = craftable_indices[ch];
                             for (int n = 0; n < 3; n++) {
-                                if (active->held_items[n] == NULL) {
-                                    active->held_items[n] = new_item(ch);
+                                if (active->held_items[n] == NO_ITEM) {
+                                    active->held_items[n] = new_item(manager, ch);
                                     break;
                                 }
                             }
-                            printf("%s crafted %s\n", active->last_name, item_names[ch]);
+                            game_print(manager, "%s crafted %s\n", active->last_name, item_names[ch]);
                             active->num_scrap -= item_costs[ch] - cost_reduction;
                             active->num_items++;
                         }
@@ -1737,7 +1904,7 @@ void game_loop(game_manager *manager)
                         int u = use(manager);
                         if (u != 0) {
                             break_loop = true;
-                            do_encounter &= u != 2;
+                            manager->do_encounter &= u != 2;
                         }
 
                         break;
@@ -1749,104 +1916,95 @@ void game_loop(game_manager *manager)
                             if (manager->characters[m] != active &&
                                 manager->characters[m]->current_room == active->current_room &&
                                 ((active->num_items > 0 && manager->characters[m]->num_items < 3) ||
-                                 (active->coolant != NULL && active->coolant == NULL) || active->num_scrap > 0)) {
+                                 (active->coolant != NO_ITEM && manager->characters[m]->coolant == NO_ITEM) || active->num_scrap > 0)) {
                                 tradeable_indices[num_tradeable++] = m;
                             }
                         }
 
                         if (num_tradeable == 0) {
-                            printf("Can't give anything right now.\n");
+                            game_print(manager, "Can't give anything right now.\n");
                         } else {
-                            printf("Give options:\n");
-                            printf("Characters:\n");
+                            game_print(manager, "Give options:\n");
+                            game_print(manager, "Characters:\n");
 
                             for (int m = 0; m < num_tradeable; m++) {
-                                printf("\t%d) %s\n", m + 1, manager->characters[tradeable_indices[m]]->last_name);
-                            }
-                            printf("\tb) Back\n");
-
-                            char ch = '\0';
-                            while (ch < '1' || ch > '0' + num_tradeable) {
-                                ch = get_character();
-
-                                if (ch == 'b') {
-                                    break;
-                                }
+                                game_print(manager, "\t%d) %s\n", m + 1, manager->characters[tradeable_indices[m]]->last_name);
                             }
+                            game_print(manager, "\tb) Back\n");
 
-                            character *give_target = manager->characters[tradeable_indices[ch - '0' - 1]];
+                            char options[12];
+                            char ch = get_choice(manager, DECISION_CHARACTER, menu_options(options, num_tradeable, "b"));
 
                             if (ch != 'b') {
-                                printf("Items:\n");
+                                character *give_target = manager->characters[tradeable_indices[ch - '0' - 1]];
+
+                                game_print(manager, "Items:\n");
 
                                 int item_indices[3];
                                 int num_items = 0;
                                 if (give_target->num_items < 3) {
                                     for (int m = 0; m < 3; m++) {
-                                        if (active->held_items[m] != NULL) {
-                                            printf("\t%d) ", m + 1);
-                                            print_item(active->held_items[m]);
-
+                                        if (active->held_items[m] != NO_ITEM) {
                                             item_indices[num_items++] = m;
+
+                                            game_print(manager, "\t%d) ", num_items);
+                                            print_item(manager->output, get_item(manager, active->held_items[m]));
                                         }
                                     }
                                 }
-                                if (active->coolant != NULL && give_target->coolant == NULL) {
-                                    printf("\tc) ");
-                                    print_item(active->coolant);
+                                menu_options(options, num_items, "b");
+                                if (active->coolant != NO_ITEM && give_target->coolant == NO_ITEM) {
+                                    game_print(manager, "\tc) ");
+                                    print_item(manager->output, get_item(manager, active->coolant));
+                                    strcat(options, "c");
                                 }
                                 if (active->num_scrap > 0) {
-                                    printf("\ts) Scrap (%d)\n", active->num_scrap);
+                                    game_print(manager, "\ts) Scrap (%d)\n", active->num_scrap);
+                                    strcat(options, "s");
                                 }
-                                printf("\tb) Back\n");
+                                game_print(manager, "\tb) Back\n");
 
-                                ch = '\0';
-                                while (ch < '1' || ch > '0' + num_items || num_items == 0) {
-                                    ch = get_character();
-
-                                    if ((give_target->coolant == NULL && ch == 'c') ||
-                                        (active->num_scrap > 0 && ch == 's') || ch == 'b') {
-                                        break;
-                                    }
-                                }
+                                ch = get_choice(manager, DECISION_ITEM, options);
 
                                 if (ch == 'b') {
                                     break;
                                 } else {
-                                    if (give_target->coolant == NULL && ch == 'c') { // Give coolant
-                                        printf("%s gave COOLANT CANISTER to %s\n",
-                                               active->last_name,
-                                               give_target->last_name);
+                                    if (ch == 'c') { // Give coolant
+                                        game_print(manager,
+                                                   "%s gave COOLANT CANISTER to %s\n",
+                                                   active->last_name,
+                                                   give_target->last_name);
                                         give_target->coolant = active->coolant;
-                                        active->coolant = NULL;
+                                        active->coolant = NO_ITEM;
                                         break_loop = true;
-                                    } else if (active->num_scrap > 0 && ch == 's') { // Give scrap
-                                        printf("How much? (Max %d) ", active->num_scrap);
+                                    } else if (ch == 's') { // Give scrap
+                                        int max_scrap = min(9, active->num_scrap);
+                                        game_print(manager, "How much? (Max %d) ", max_scrap);
 
-                                        ch = '\0';
-                                        while (ch < '1' || ch > '0' + active->num_scrap) {
-                                            ch = get_character();
-                                        }
+                                        ch = get_choice(manager, DECISION_AMOUNT, menu_options(options, max_scrap, ""));
                                         ch -= '0';
 
                                         active->num_scrap -= ch;
                                         give_target->num_scrap += ch;
 
-                                        printf("%s gave %s %d Scrap.\n", active->last_name, give_target->last_name, ch);
+                                        game_print(manager, "%s gave %s %d Scrap.\n", active->last_name, give_target->last_name, ch);
                                         break_loop = true;
                                     } else { // Give item
+                                        int given_index = item_indices[ch - '0' - 1];
+                                        item_id given = active->held_items[given_index];
                                         for (int m = 0; m < 3; m++) {
-                                            if (give_target->held_items[m] == NULL) {
-                                                give_target->held_items[m] = active->held_items[ch - '0' - 1];
-                                                active->held_items[ch - '0' - 1] = NULL;
+                                            if (give_target->held_items[m] == NO_ITEM) {
+                                                give_target->held_items[m] = given;
+                                                active->held_items[given_index] = NO_ITEM;
                                                 break;
                                             }
                                         }
 
-                                        printf("%s gave %s to %s\n",
-                                               active->last_name,
-                                               item_names[give_target->held_items[ch - '0' - 1]->type],
-                                               give_target->last_name);
+                                        game_print(manager,
+                                                   "%s gave %s to %s\n",
+                                                   active->last_name,
+                                                   item_names[get_item(manager, given)->type],
+                                                   give_target->last_name);
 
                                         active->num_items--;
                                         give_target->num_items++;
@@ -1859,33 +2017,39 @@ void game_loop(game_manager *manager)
 
                         break;
                     case 's':
-                        printf("%s's turn ends\n", active->last_name);
-                        j = 0;
+                        game_print(manager, "%s's turn ends\n", active->last_name);
+                        active->current_actions = 0;
                         break_loop = true;
 
                         break;
                     case 'v':
-                        print_room(active->current_room, 1);
+                        print_room(manager->output,
+                                   manager->game_map,
+                                   active->current_room,
+                                   get_room_state(manager, active->current_room),
+                                   manager->items,
+                                   1);
 
                         break;
                     case 'l':
                         for (int i = 0; i < manager->character_count; i++) {
-                            printf("%s at %s\n",
-                                   manager->characters[i]->last_name,
-                                   manager->characters[i]->current_room->name);
+                            game_print(manager,
+                                       "%s at %s\n",
+                                       manager->characters[i]->last_name,
+                                       manager->characters[i]->current_room->name);
                         }
-                        printf("Xenomorph at %s\n", manager->xenomorph_location->name);
+                        game_print(manager, "Xenomorph at %s\n", manager->xenomorph_location->name);
                         if (manager->ash_location != NULL) {
-                            printf("Ash at %s\n", manager->ash_location->name);
+                            game_print(manager, "Ash at %s\n", manager->ash_location->name);
                         }
 
                         break;
                     case 'o':
                         if (manager->is_final_mission) {
-                            printf("------%s------\n", final_mission_names[manager->final_mission_type]);
-                            printf("%s\n", final_mission_desc[manager->final_mission_type]);
+                            game_print(manager, "------%s------\n", final_mission_names[manager->final_mission_type]);
+                            game_print(manager, "%s\n", final_mission_desc[manager->final_mission_type]);
                             if (manager->final_mission_type == YOU_HAVE_MY_SYMPATHIES) {
-                                printf("Ash health: %d\n", manager->ash_health);
+                                game_print(manager, "Ash health: %d\n", manager->ash_health);
                             }
                         } else {
                             print_game_objectives(manager);
@@ -1895,37 +2059,58 @@ void game_loop(game_manager *manager)
                     case 'n':
                         if (manager->final_mission_type == BLOW_IT_OUT_INTO_SPACE) {
                             if (manager->active_character->num_scrap == 0) {
-                                printf("Must have at least 1 Scrap to use this ability.\n");
+                                game_print(manager, "Must have at least 1 Scrap to use this ability.\n");
                                 break_loop = false;
                             } else {
-                                ability_output *ao = lambert_ability(manager->game_map, manager->characters, active);
+                                ability_output *ao = lambert_ability(manager, active);
 
                                 break_loop = ao->use_action;
-                                used_ability = false;
+                                manager->used_ability = false;
 
                                 if (break_loop) {
                                     manager->active_character->num_scrap--;
                                 }
-
-                                free(ao);
                             }
                         } else {
                             recognized = false;
                         }
                         break;
                     case 'q':
-                        printf("%s\n", manager->game_map->ascii_map);
+                        game_print(manager, "%s\n", manager->game_map->ascii_map);
 
                         break;
                     case 'r':
-                        print_map(manager->game_map);
+                        print_map(manager->output, manager->game_map);
+
+                        break;
+                    case 'w':
+                        if (manager->save_file != NULL) {
+                            save_game(manager);
+                        } else {
+                            recognized = false;
+                        }
+
+                        break;
+                    case 'f':
+                        if (manager->save_file != NULL && manager->recording) {
+                            // Replays can't load the save, so the log would diverge here
+                            game_print(manager, "Games that are being recorded can't load saved games\n");
+                        } else if (manager->save_file != NULL) {
+                            game_print(manager, "Load %s? Unsaved progress will be lost. (y/n)\n", manager->save_file);
+                            if (get_choice(manager, DECISION_CONFIRM, "yn") == 'y') {
+                                load_game(manager);
+                            }
+                        } else {
+                            recognized = false;
+                        }
 
                         break;
                     case 'e':
-                        printf("Are you sure you want to exit? Game progress will not be saved. "
-                               "(y/n)\n");
-                        if (get_character() == 'y') {
-                            exit(0);
+                        game_print(manager,
+                                   "Are you sure you want to exit? Game progress will not be saved. "
+                                   "(y/n)\n");
+                        if (manager->input->choose(manager->input, manager, DECISION_CONFIRM, "yn") == 'y') {
+                            end_game(manager, GAME_EXITED);
                         }
 
                         break;
@@ -1937,16 +2122,44 @@ void game_loop(game_manager *manager)
                     if (break_loop) {
                         break;
                     } else if (!recognized) {
-                        printf("Unrecognized command\n");
+                        game_print(manager, "Unrecognized command\n");
                     }
                 }
             }
 
-            if (do_encounter) {
+            if (manager->do_encounter) {
                 trigger_encounter(manager);
             }
+
+            active->current_actions = 0;
+            manager->turn_in_progress = false;
+        }
+
+        if (manager->max_rounds > 0 && manager->round_index >= manager->max_rounds) {
+            end_game(manager, GAME_ROUND_LIMIT);
         }
 
         manager->round_index++;
+        manager->turn_index = 0;
+    }
+}
+
+/**
+ * Main game loop, plays the game until it is won, lost, or stopped
+ * @param  manager                Game manager
+ * @return          How and when the game ended
+ */
+game_outcome game_loop(game_manager *manager)
+{
+    jmp_buf end_of_game;
+    manager->end_of_game = &end_of_game;
+
+    // Loading a saved game jumps back here too, to resume it from the top of the loop
+    if (setjmp(end_of_game) != GAME_OVER_JUMP) {
+        _play_rounds(manager);
     }
+
+    manager->end_of_game = NULL;
+
+    return manager->outcome;
 }
@@ -0,0 +1,464 @@
+/**
+ * @file
+ * @date   16-Oct-2026
+ * @brief Writing and memory-mapping binary compiled maps
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "map/compiled_map.h"
+
+// adjacency_offsets and named_room_indices are used in place as int arrays
+_Static_assert(sizeof(int) == sizeof(int32_t), "compiled maps store int arrays as int32_t");
+
+/**
+ * Check whether an open map file is a compiled map image, leaving the file at its start
+ * @param  fp                Open map file
+ * @return    True if the file starts with COMPILED_MAP_MAGIC
+ */
+bool is_compiled_map(FILE *fp)
+{
+    char magic[sizeof(COMPILED_MAP_MAGIC)];
+    size_t read = fread(magic, 1, sizeof(magic), fp);
+    rewind(fp);
+
+    return read == sizeof(magic) && memcmp(magic, COMPILED_MAP_MAGIC, sizeof(magic)) == 0;
+}
+
+/**
+ * Reserve space for the next section of an image being laid out
+ * @param section     Section to place
+ * @param size        Size of the section in bytes
+ * @param image_size  Size of the image so far, advanced past the section
+ */
+void _place_section(compiled_map_section *section, uint64_t size, uint64_t *image_size)
+{
+    section->offset = size > 0 ? *image_size : 0;
+    section->size = size;
+
+    *image_size += (size + COMPILED_MAP_ALIGNMENT - 1) / COMPILED_MAP_ALIGNMENT * COMPILED_MAP_ALIGNMENT;
+}
+
+/**
+ * Write a section of an image, padded to COMPILED_MAP_ALIGNMENT
+ * @param fp       Image file being written
+ * @param section  Where the section was placed by _place_section
+ * @param data     Contents of the section
+ */
+void _write_section(FILE *fp, const compiled_map_section *section, const void *data)
+{
+    if (section->size == 0) {
+        return;
+    }
+
+    static const char padding[COMPILED_MAP_ALIGNMENT] = {0};
+    fseek(fp, section->offset, SEEK_SET);
+    fwrite(data, 1, section->size, fp);
+    fwrite(padding, 1, (COMPILED_MAP_ALIGNMENT - section->size % COMPILED_MAP_ALIGNMENT) % COMPILED_MAP_ALIGNMENT, fp);
+}
+
+/**
+ * Copy a list of special rooms into an array of room ids
+ * @param  rooms                 Rooms to copy
+ * @param  count                 Number of rooms
+ * @return       Newly allocated array of the rooms' ids
+ */
+room_id *_room_ids(room **rooms, int count)
+{
+    room_id *ids = (room_id *)malloc(sizeof(room_id) * max(count, 1));
+    for (int i = 0; i < count; i++) {
+        ids[i] = rooms[i]->id;
+    }
+
+    return ids;
+}
+
+/**
+ * Write a map read by read_map out as a compiled map image
+ * @param  game_map               Map to compile
+ * @param  fn                     Filename of the image to write
+ * @param  error                  Filled in with the reason if the image can't be written
+ * @return          True on success
+ */
+bool write_compiled_map(const map *game_map, const char *fn, map_error *error)
+{
+    int n = game_map->room_count;
+
+    compiled_map_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, COMPILED_MAP_MAGIC, sizeof(COMPILED_MAP_MAGIC));
+    header.version = COMPILED_MAP_VERSION;
+    header.byte_order = COMPILED_MAP_BYTE_ORDER;
+    memcpy(header.name, game_map->name, sizeof(header.name));
+
+    header.room_count = n;
+    header.named_room_count = game_map->named_room_count;
+    header.scrap_room_count = game_map->scrap_room_count;
+    header.event_room_count = game_map->event_room_count;
+    header.coolant_room_count = game_map->coolant_room_count;
+    header.room_index_capacity = game_map->room_index_capacity;
+
+    header.player_start_room = game_map->player_start_room->id;
+    header.xenomorph_start_room = game_map->xenomorph_start_room->id;
+    header.ash_start_room = game_map->ash_start_room->id;
+
+    compiled_room *rooms = (compiled_room *)calloc(max(n, 1), sizeof(compiled_room));
+    for (int i = 0; i < n; i++) {
+        memcpy(rooms[i].name, game_map->rooms[i]->name, sizeof(rooms[i].name));
+        rooms[i].ladder_connection =
+            game_map->rooms[i]->ladder_connection != NULL ? game_map->rooms[i]->ladder_connection->id : NO_ROOM;
+        rooms[i].is_corridor = game_map->rooms[i]->is_corridor;
+    }
+
+    room_id *scrap_rooms = _room_ids(game_map->scrap_rooms, game_map->scrap_room_count);
+    room_id *event_rooms = _room_ids(game_map->event_rooms, game_map->event_room_count);
+    room_id *coolant_rooms = _room_ids(game_map->coolant_rooms, game_map->coolant_room_count);
+
+    uint64_t table_size = game_map->distances != NULL ? (uint64_t)n * n : 0;
+    uint64_t ring_size =
+        game_map->rooms_at_distance != NULL ? sizeof(room_set) * n * (MAX_RING_DISTANCE + 1) : 0;
+
+    // Lay out every section after the header
+    uint64_t image_size = (sizeof(header) + COMPILED_MAP_ALIGNMENT - 1) / COMPILED_MAP_ALIGNMENT * COMPILED_MAP_ALIGNMENT;
+    _place_section(&header.rooms, sizeof(compiled_room) * n, &image_size);
+    _place_section(&header.adjacency_offsets, sizeof(int32_t) * (n + 1), &image_size);
+    _place_section(&header.adjacency, sizeof(room_id) * game_map->adjacency_offsets[n], &image_size);
+    _place_section(&header.named_room_indices, sizeof(int32_t) * game_map->named_room_count, &image_size);
+    _place_section(&header.scrap_rooms, sizeof(room_id) * game_map->scrap_room_count, &image_size);
+    _place_section(&header.event_rooms, sizeof(room_id) * game_map->event_room_count, &image_size);
+    _place_section(&header.coolant_rooms, sizeof(room_id) * game_map->coolant_room_count, &image_size);
+    _place_section(&header.room_index, sizeof(room_id) * game_map->room_index_capacity, &image_size);
+    _place_section(&header.ascii_map, strlen(game_map->ascii_map) + 1, &image_size);
+    _place_section(&header.distances, table_size, &image_size);
+    _place_section(&header.next_hop, table_size, &image_size);
+    _place_section(&header.rooms_at_distance, ring_size, &image_size);
+    _place_section(&header.rooms_within_distance, ring_size, &image_size);
+    header.image_size = image_size;
+
+    FILE *fp = fopen(fn, "wb");
+    bool ok = fp != NULL;
+    if (!ok) {
+        map_error_at(error, 0, 0, "Failed to open compiled map for writing: %s", strerror(errno));
+    }
+
+    if (ok) {
+        fwrite(&header, sizeof(header), 1, fp);
+        _write_section(fp, &header.rooms, rooms);
+        _write_section(fp, &header.adjacency_offsets, game_map->adjacency_offsets);
+        _write_section(fp, &header.adjacency, game_map->adjacency);
+        _write_section(fp, &header.named_room_indices, game_map->named_room_indices);
+        _write_section(fp, &header.scrap_rooms, scrap_rooms);
+        _write_section(fp, &header.event_rooms, event_rooms);
+        _write_section(fp, &header.coolant_rooms, coolant_rooms);
+        _write_section(fp, &header.room_index, game_map->room_index);
+        _write_section(fp, &header.ascii_map, game_map->ascii_map);
+        _write_section(fp, &header.distances, game_map->distances);
+        _write_section(fp, &header.next_hop, game_map->next_hop);
+        _write_section(fp, &header.rooms_at_distance, game_map->rooms_at_distance);
+        _write_section(fp, &header.rooms_within_distance, game_map->rooms_within_distance);
+
+        bool write_failed = ferror(fp);
+        if (fclose(fp) != 0 || write_failed) {
+            ok = map_error_at(error, 0, 0, "Failed to write compiled map");
+        }
+    }
+
+    free(rooms);
+    free(scrap_rooms);
+    free(event_rooms);
+    free(coolant_rooms);
+
+    return ok;
+}
+
+/**
+ * Get a pointer to a section of a mapped image
+ * @param  header                 Header of the mapped image
+ * @param  section                Section to find
+ * @param  expected_size          Size the section must have given the header's counts
+ * @param  valid                  Set to false if the section doesn't fit in the image or has the wrong size
+ * @return         Pointer to the section in the image, NULL for empty or invalid sections
+ */
+void *_section_data(const compiled_map_header *header,
+                    const compiled_map_section *section,
+                    uint64_t expected_size,
+                    bool *valid)
+{
+    if (section->size != expected_size || section->offset % COMPILED_MAP_ALIGNMENT != 0 ||
+        section->offset > header->image_size || section->size > header->image_size - section->offset) {
+        *valid = false;
+        return NULL;
+    }
+
+    return section->size > 0 ? (char *)header + section->offset : NULL;
+}
+
+/**
+ * Turn a section of room ids into a list of room pointers
+ * @param  game_map                Map being loaded, with its rooms set up
+ * @param  ids                     Room ids from the image
+ * @param  count                   Number of ids
+ * @param  valid                   Set to false if an id is out of range
+ * @return          Newly allocated array of room pointers
+ */
+room **_room_pointers(const map *game_map, const room_id *ids, int count, bool *valid)
+{
+    room **rooms = (room **)malloc(sizeof(room *) * max(count, 1));
+    for (int i = 0; i < count; i++) {
+        if (ids[i] >= game_map->room_count) {
+            *valid = false;
+            return rooms;
+        }
+
+        rooms[i] = game_map->rooms[ids[i]];
+    }
+
+    return rooms;
+}
+
+/**
+ * Check that every room id and index in the tables of a mapped image is in range, so nothing read from a
+ * corrupt image can index past the map's rooms
+ * @param  game_map                Map being loaded, with its tables pointing into the image
+ * @param  rooms                   Rooms of the image
+ * @param  n                       Number of rooms in the image
+ * @return          True if every table is consistent
+ */
+bool _compiled_tables_valid(const map *game_map, const compiled_room *rooms, int n)
+{
+    // Rows of the adjacency only move forward, and end exactly at the end of its section
+    const int *offsets = game_map->adjacency_offsets;
+    if (offsets[0] != 0) {
+        return false;
+    }
+    for (int i = 0; i < n; i++) {
+        if (offsets[i + 1] < offsets[i]) {
+            return false;
+        }
+    }
+    for (int e = 0; e < offsets[n]; e++) {
+        if (game_map->adjacency[e] >= n) {
+            return false;
+        }
+    }
+
+    for (int i = 0; i < n; i++) {
+        if (rooms[i].ladder_connection != NO_ROOM && rooms[i].ladder_connection >= n) {
+            return false;
+        }
+    }
+
+    for (int i = 0; i < game_map->named_room_count; i++) {
+        if (game_map->named_room_indices[i] < 0 || game_map->named_room_indices[i] >= n) {
+            return false;
+        }
+    }
+
+    // Lookups probe until they reach an empty slot, so there must be one
+    bool has_empty_slot = false;
+    for (int i = 0; i < game_map->room_index_capacity; i++) {
+        if (game_map->room_index[i] == NO_ROOM) {
+            has_empty_slot = true;
+        } else if (game_map->room_index[i] >= n) {
+            return false;
+        }
+    }
+    if (!has_empty_slot) {
+        return false;
+    }
+
+    if (game_map->distances != NULL) {
+        for (int i = 0; i < n * n; i++) {
+            if (game_map->next_hop[i] >= n ||
+                (game_map->distances[i] != UNREACHABLE_DISTANCE && game_map->distances[i] >= n)) {
+                return false;
+            }
+        }
+    }
+
+    if (game_map->rooms_at_distance != NULL) {
+        if (n > 64) {
+            return false;
+        }
+
+        room_set all_rooms = n == 64 ? ~(room_set)0 : ((room_set)1 << n) - 1;
+        for (int i = 0; i < n * (MAX_RING_DISTANCE + 1); i++) {
+            if ((game_map->rooms_at_distance[i] | game_map->rooms_within_distance[i]) & ~all_rooms) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Load a compiled map image written by write_compiled_map. The image is memory-mapped and its
+ * tables are used in place, only the rooms' game state is allocated
+ * @param  fn               Filename of compiled map image
+ * @param  error            Filled in with the reason if the image can't be loaded
+ * @return    Pointer to new map, release it with free_map. NULL on error
+ */
+map *load_compiled_map(const char *fn, map_error *error)
+{
+    int fd = open(fn, O_RDONLY);
+    if (fd < 0) {
+        map_error_at(error, 0, 0, "Failed to open map file: %s", strerror(errno));
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(compiled_map_header)) {
+        close(fd);
+        map_error_at(error, 0, 0, "Compiled map is corrupt");
+        return NULL;
+    }
+
+    void *image = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (image == MAP_FAILED) {
+        map_error_at(error, 0, 0, "Failed to map compiled map: %s", strerror(errno));
+        return NULL;
+    }
+
+    const compiled_map_header *header = (const compiled_map_header *)image;
+    if (memcmp(header->magic, COMPILED_MAP_MAGIC, sizeof(COMPILED_MAP_MAGIC)) != 0 ||
+        header->byte_order != COMPILED_MAP_BYTE_ORDER || header->version != COMPILED_MAP_VERSION) {
+        munmap(image, st.st_size);
+        map_error_at(error, 0, 0, "Compiled map was written by an incompatible version, recompile it with --compile-map");
+        return NULL;
+    }
+
+    int n = header->room_count;
+    if (header->image_size != (uint64_t)st.st_size || n <= 0 || n >= NO_ROOM ||
+        header->player_start_room >= n || header->xenomorph_start_room >= n || header->ash_start_room >= n ||
+        header->named_room_count < 0 || header->scrap_room_count < 0 || header->event_room_count < 0 ||
+        header->coolant_room_count < 0 || header->room_index_capacity <= 0 ||
+        (header->room_index_capacity & (header->room_index_capacity - 1)) != 0) {
+        munmap(image, st.st_size);
+        map_error_at(error, 0, 0, "Compiled map is corrupt");
+        return NULL;
+    }
+
+    map *new_map = (map *)calloc(1, sizeof(map));
+    memcpy(new_map->name, header->name, sizeof(new_map->name));
+    new_map->name[sizeof(new_map->name) - 1] = '\0';
+    new_map->image = image;
+    new_map->image_size = st.st_size;
+
+    // Tables used in place
+    bool valid = true;
+    new_map->adjacency_offsets =
+        (int *)_section_data(header, &header->adjacency_offsets, sizeof(int32_t) * (n + 1), &valid);
+    new_map->adjacency = (room_id *)_section_data(
+        header,
+        &header->adjacency,
+        valid ? sizeof(room_id) * (uint64_t)new_map->adjacency_offsets[n] : 0,
+        &valid);
+
+    new_map->named_room_count = header->named_room_count;
+    new_map->named_room_capacity = header->named_room_count;
+    new_map->named_room_indices =
+        (int *)_section_data(header, &header->named_room_indices, sizeof(int32_t) * header->named_room_count, &valid);
+
+    new_map->room_index_capacity = header->room_index_capacity;
+    new_map->room_index = (room_id *)_section_data(
+        header, &header->room_index, sizeof(room_id) * (uint64_t)header->room_index_capacity, &valid);
+
+    new_map->ascii_map = (char *)_section_data(header, &header->ascii_map, header->ascii_map.size, &valid);
+    if (new_map->ascii_map == NULL || new_map->ascii_map[header->ascii_map.size - 1] != '\0') {
+        valid = false;
+    }
+
+    uint64_t table_size = header->distances.size > 0 ? (uint64_t)n * n : 0;
+    new_map->distances = (unsigned char *)_section_data(header, &header->distances, table_size, &valid);
+    new_map->next_hop = (unsigned char *)_section_data(header, &header->next_hop, table_size, &valid);
+
+    uint64_t ring_size = header->rooms_at_distance.size > 0 ? sizeof(room_set) * n * (MAX_RING_DISTANCE + 1) : 0;
+    new_map->rooms_at_distance = (room_set *)_section_data(header, &header->rooms_at_distance, ring_size, &valid);
+    new_map->rooms_within_distance =
+        (room_set *)_section_data(header, &header->rooms_within_distance, ring_size, &valid);
+
+    const compiled_room *compiled_rooms =
+        (const compiled_room *)_section_data(header, &header->rooms, sizeof(compiled_room) * n, &valid);
+    const room_id *scrap_rooms = (const room_id *)_section_data(
+        header, &header->scrap_rooms, sizeof(room_id) * header->scrap_room_count, &valid);
+    const room_id *event_rooms = (const room_id *)_section_data(
+        header, &header->event_rooms, sizeof(room_id) * header->event_room_count, &valid);
+    const room_id *coolant_rooms = (const room_id *)_section_data(
+        header, &header->coolant_rooms, sizeof(room_id) * header->coolant_room_count, &valid);
+
+    if (!valid || !_compiled_tables_valid(new_map, compiled_rooms, n)) {
+        free_compiled_map(new_map);
+        map_error_at(error, 0, 0, "Compiled map is corrupt");
+        return NULL;
+    }
+
+    // Rooms hold game state, so they are the only part of the map allocated, all in one block
+    new_map->room_count = n;
+    new_map->room_capacity = n;
+    new_map->room_block = (room *)malloc(sizeof(room) * n);
+    new_map->rooms = (room **)malloc(sizeof(room *) * n);
+    for (int i = 0; i < n; i++) {
+        new_map->rooms[i] = &new_map->room_block[i];
+    }
+
+    for (int i = 0; i < n; i++) {
+        room *r = new_map->rooms[i];
+
+        memcpy(r->name, compiled_rooms[i].name, sizeof(r->name));
+        r->name[sizeof(r->name) - 1] = '\0';
+        r->id = i;
+        r->is_corridor = compiled_rooms[i].is_corridor;
+        r->ladder_connection = compiled_rooms[i].ladder_connection != NO_ROOM
+                                   ? new_map->rooms[compiled_rooms[i].ladder_connection]
+                                   : NULL;
+    }
+
+    new_map->player_start_room = new_map->rooms[header->player_start_room];
+    new_map->xenomorph_start_room = new_map->rooms[header->xenomorph_start_room];
+    new_map->ash_start_room = new_map->rooms[header->ash_start_room];
+
+    new_map->scrap_room_count = header->scrap_room_count;
+    new_map->scrap_room_capacity = header->scrap_room_count;
+    new_map->scrap_rooms = _room_pointers(new_map, scrap_rooms, header->scrap_room_count, &valid);
+    new_map->event_room_count = header->event_room_count;
+    new_map->event_room_capacity = header->event_room_count;
+    new_map->event_rooms = _room_pointers(new_map, event_rooms, header->event_room_count, &valid);
+    new_map->coolant_room_count = header->coolant_room_count;
+    new_map->coolant_room_capacity = header->coolant_room_count;
+    new_map->coolant_rooms = _room_pointers(new_map, coolant_rooms, header->coolant_room_count, &valid);
+
+    if (!valid) {
+        free_compiled_map(new_map);
+        map_error_at(error, 0, 0, "Compiled map is corrupt");
+        return NULL;
+    }
+
+    new_map->docking_bay = get_room(new_map, "DOCKING BAY");
+    new_map->airlock = get_room(new_map, "AIRLOCK");
+    new_map->bridge = get_room(new_map, "BRIDGE");
+    new_map->equipment_storage = get_room(new_map, "EQUIPMENT STORAGE");
+    new_map->mu_th_ur = get_room(new_map, "MU-TH-UR");
+
+    return new_map;
+}
+
+/**
+ * Free a map loaded by load_compiled_map, unmapping its image
+ * @param game_map  The map to free
+ */
+void free_compiled_map(map *game_map)
+{
+    free(game_map->room_block);
+    free(game_map->rooms);
+    free(game_map->scrap_rooms);
+    free(game_map->event_rooms);
+    free(game_map->coolant_rooms);
+    munmap(game_map->image, game_map->image_size);
+    free(game_map);
+}
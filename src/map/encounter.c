@@ -5,7 +5,11 @@
  * @brief Logic and data for encounters
 */
 
+#include <pthread.h>
+#include <stdatomic.h>
+
 #include "map/encounter.h"
+#include "utils.h"
 
 char *encounter_names[7] = {"QUIET",
                             "ALIEN - Lost The Signal",
@@ -15,8 +19,8 @@ char *encounter_names[7] = {"QUIET",
                             "ORDER 937 - Crew Expendable",
                             "ORDER 937 - Collating Data"};
 
-int num_encounters = ENCOUNTER_STACK_SIZE;
-ENCOUNTER_TYPES encounters[ENCOUNTER_STACK_SIZE] = {
+// The encounter stack every game starts with
+const ENCOUNTER_TYPES encounter_deck[ENCOUNTER_STACK_SIZE] = {
     QUIET,
     QUIET,
     QUIET,
@@ -40,135 +44,317 @@ ENCOUNTER_TYPES encounters[ENCOUNTER_STACK_SIZE] = {
     ORDER937_Collating_Data,
 };
 
-ENCOUNTER_TYPES discard_encounters[ENCOUNTER_STACK_SIZE] = {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-                                                            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1};
+/**
+ * Put every card of a new game's encounter deck in the encounters stack, unshuffled
+ * @param stack  Encounter stack to reset
+ */
+void reset_encounters(encounter_stack *stack)
+{
+    memset(stack, 0, sizeof(encounter_stack));
+
+    stack->num_encounters = ENCOUNTER_STACK_SIZE;
+    for (int i = 0; i < ENCOUNTER_STACK_SIZE; i++) {
+        stack->encounters[i] = encounter_deck[i];
+        stack->remaining[encounter_deck[i]]++;
+    }
+}
 
 /**
  * Shuffle the encounters deck
+ * @param stack  Encounter stack to shuffle
+ * @param rng    Generator to shuffle with
  */
-void shuffle_encounters()
+void shuffle_encounters(encounter_stack *stack, random_state *rng)
 {
-    for (int i = num_encounters; i > 0; i--) {
-        int j = rand() % (i + 1);
+    for (int i = stack->num_encounters - 1; i > 0; i--) {
+        int j = randint(rng, 0, i);
 
-        ENCOUNTER_TYPES tmp = encounters[i];
-        encounters[i] = encounters[j];
-        encounters[j] = tmp;
+        int8_t tmp = stack->encounters[i];
+        stack->encounters[i] = stack->encounters[j];
+        stack->encounters[j] = tmp;
     }
 }
 
 /**
- * Draws an encounter card, discards it, and returns the index of the card in discard_encounters
- * @return Index of the card in discard_encounters
+ * Draws an encounter card and discards it. If the stack is empty, the discard pile is shuffled back into it first
+ * @param stack  Encounter stack to draw from
+ * @param rng    Generator to shuffle with if the stack is empty
+ * @return       The card drawn
  */
-int draw_encounter()
+ENCOUNTER_TYPES draw_encounter(encounter_stack *stack, random_state *rng)
 {
-    if (num_encounters <= 0) {
-        return -1;
+    if (stack->num_encounters <= 0) {
+        replace_all_encounters(stack, rng);
     }
 
-    return discard_encounter();
+    ENCOUNTER_TYPES encounter = stack->encounters[--stack->num_encounters];
+    stack->remaining[encounter]--;
+    stack->discarded[encounter]++;
+
+    return encounter;
+}
+
+/**
+ * Moves a card from the discard pile back to the top of the encounters stack, so it is drawn next
+ * @param stack      Encounter stack to return the card to
+ * @param encounter  Type of the card, at least one must be in the discard pile
+ */
+void return_encounter(encounter_stack *stack, ENCOUNTER_TYPES encounter)
+{
+    stack->discarded[encounter]--;
+    stack->remaining[encounter]++;
+    stack->encounters[stack->num_encounters++] = encounter;
 }
 
 /**
- * Moves card from top of encounters stack to top of discard_encounters stack
- * @return index of discarded card in discard_encounters
+ * Chance that the next card drawn is of a type. Ignores the reshuffle of an empty stack
+ * @param stack      Encounter stack to draw from
+ * @param encounter  Type of the card
+ * @return           Chance from 0 to 1
  */
-int discard_encounter()
+double encounter_probability(const encounter_stack *stack, ENCOUNTER_TYPES encounter)
 {
-    if (num_encounters <= 0) {
-        return -1;
+    if (stack->num_encounters <= 0) {
+        return 0;
     }
 
-    discard_encounters[ENCOUNTER_STACK_SIZE - num_encounters] = encounters[num_encounters - 1];
-    encounters[num_encounters - 1] = -1;
-    num_encounters--;
-    return ENCOUNTER_STACK_SIZE - num_encounters - 1;
+    return (double)stack->remaining[encounter] / stack->num_encounters;
 }
 
+// encounter_binomials[n][k] is n choose k, exact in a double for every n up to the size of the deck. Entries
+// with k > n stay 0
+double encounter_binomials[ENCOUNTER_STACK_SIZE + 1][ENCOUNTER_STACK_SIZE + 1];
+// encounter_mix_table[d] holds every mix of d cards, encounter_num_mixes[d] of them
+encounter_mix encounter_mix_table[ENCOUNTER_ODDS_MAX_DRAWS + 1][ENCOUNTER_MAX_MIXES];
+int encounter_num_mixes[ENCOUNTER_ODDS_MAX_DRAWS + 1];
+// A stack's makeup is the sum over types of the cards of that type left times the type's radix
+int encounter_makeup_radix[NUM_ENCOUNTER_TYPES];
+pthread_once_t encounter_tables_once = PTHREAD_ONCE_INIT;
+
+// get_encounter_odds' answer for each makeup and number of draws, computed the first time it is asked for
+_Atomic(encounter_odds *) encounter_odds_cache[NUM_ENCOUNTER_MAKEUPS][ENCOUNTER_ODDS_MAX_DRAWS + 1];
+
 /**
- * Moves card from top of discard_encounters stack to top of encounters stack
+ * Add every mix of `left` more cards among the types from `type` on to encounter_mix_table[draws]
  */
-void replace_encounter()
+void _add_encounter_mixes(int draws, int type, int left, encounter_mix *mix)
 {
-    if (num_encounters >= ENCOUNTER_STACK_SIZE) {
+    if (type == NUM_ENCOUNTER_TYPES - 1) {
+        mix->counts[type] = left;
+        encounter_mix_table[draws][encounter_num_mixes[draws]++] = *mix;
         return;
     }
 
-    encounters[num_encounters] = discard_encounters[ENCOUNTER_STACK_SIZE - num_encounters - 1];
-    discard_encounters[ENCOUNTER_STACK_SIZE - num_encounters - 1] = -1;
-    num_encounters++;
+    for (int count = left; count >= 0; count--) {
+        mix->counts[type] = count;
+        _add_encounter_mixes(draws, type + 1, left - count, mix);
+    }
 }
 
 /**
- * Put all encounter cards back in the stack
+ * Fill in encounter_binomials with Pascal's triangle, and the mixes and makeups get_encounter_odds uses
  */
-void replace_all_encounters()
+void _init_encounter_tables(void)
 {
-    while (num_encounters < ENCOUNTER_STACK_SIZE) {
-        replace_encounter();
+    for (int n = 0; n <= ENCOUNTER_STACK_SIZE; n++) {
+        encounter_binomials[n][0] = 1;
+        for (int k = 1; k <= n; k++) {
+            encounter_binomials[n][k] = encounter_binomials[n - 1][k - 1] + encounter_binomials[n - 1][k];
+        }
+    }
+
+    for (int draws = 0; draws <= ENCOUNTER_ODDS_MAX_DRAWS; draws++) {
+        encounter_mix mix;
+        _add_encounter_mixes(draws, 0, draws, &mix);
+    }
+
+    int in_deck[NUM_ENCOUNTER_TYPES] = {0};
+    for (int i = 0; i < ENCOUNTER_STACK_SIZE; i++) {
+        in_deck[encounter_deck[i]]++;
+    }
+    int radix = 1;
+    for (int type = 0; type < NUM_ENCOUNTER_TYPES; type++) {
+        encounter_makeup_radix[type] = radix;
+        radix *= in_deck[type] + 1;
     }
-    shuffle_encounters();
 }
 
 /**
- * Replace a discarded card at position i
- * @param idx  Index in discarded pile
- * @return     Whether or not the replace was successful
+ * Get every mix of cards that a number of draws can give, in the order of encounter_odds.mixes
+ * @param  draws      Number of cards drawn, at most ENCOUNTER_ODDS_MAX_DRAWS
+ * @param  num_mixes  Set to the number of mixes
+ * @return            The mixes
  */
-bool replace_card(int idx)
+const encounter_mix *encounter_mixes(int draws, int *num_mixes)
 {
-    if (num_encounters >= ENCOUNTER_STACK_SIZE) {
-        return false;
-    }
+    pthread_once(&encounter_tables_once, _init_encounter_tables);
+
+    *num_mixes = encounter_num_mixes[draws];
 
-    encounters[num_encounters] = discard_encounters[idx];
-    discard_encounters[idx] = -1;
-    num_encounters++;
-
-    for (int i = 0; i < ENCOUNTER_STACK_SIZE - 1; i++) {
-        if (discard_encounters[i] == -1) {
-            int j;
-            for (j = i; j < ENCOUNTER_STACK_SIZE; j++) {
-                if (discard_encounters[j] != -1) {
-                    break;
-                }
-            }
-            if (j == ENCOUNTER_STACK_SIZE - 1) {
-                break;
-            }
-            discard_encounters[i] = discard_encounters[j];
+    return encounter_mix_table[draws];
+}
+
+/**
+ * Count the alien and ORDER 937 cards among counts of each type
+ */
+void _count_encounter_classes(const int8_t *counts, int *aliens, int *order937s)
+{
+    *aliens = counts[ALIEN_Lost_The_Signal] + counts[ALIEN_Stalk] + counts[ALIEN_Hunt];
+    *order937s = counts[ORDER937_Meet_Me_In_The_Infirmary] + counts[ORDER937_Crew_Expendable] +
+                 counts[ORDER937_Collating_Data];
+}
+
+/**
+ * Work out the odds get_encounter_odds caches
+ */
+void _compute_encounter_odds(const encounter_stack *stack, int draws, encounter_odds *odds)
+{
+    int left = stack->num_encounters;
+
+    memset(odds, 0, sizeof(encounter_odds));
+    odds->draws = draws;
+    odds->num_mixes = encounter_num_mixes[draws];
+
+    // Multivariate hypergeometric: ways to pick each mix over ways to pick any `draws` cards. The chances of
+    // classes and single types add up the mixes they are part of
+    for (int i = 0; i < odds->num_mixes; i++) {
+        const encounter_mix *mix = &encounter_mix_table[draws][i];
+
+        double ways = 1;
+        for (int type = 0; type < NUM_ENCOUNTER_TYPES; type++) {
+            ways *= encounter_binomials[stack->remaining[type]][mix->counts[type]];
         }
-    }
+        odds->mixes[i] = ways / encounter_binomials[left][draws];
 
-    return true;
+        int aliens, order937s;
+        _count_encounter_classes(mix->counts, &aliens, &order937s);
+        odds->chance[aliens][order937s] += odds->mixes[i];
+        for (int type = 0; type < NUM_ENCOUNTER_TYPES; type++) {
+            odds->by_type[type][mix->counts[type]] += odds->mixes[i];
+        }
+    }
 }
 
 /**
- * Replaces all alien cards in discard_encounters
+ * Exact chance of every mix of card types among the next draws, for bots and searches that weigh what comes
+ * next instead of sampling it. The stack is taken to be in an unknown order. Cards put back by encounters drawn
+ * along the way, and the reshuffle of an empty stack, aren't accounted for. Odds only depend on how many cards
+ * of each type are left, so each makeup's are worked out once, shared by every game and thread, and kept for
+ * the rest of the program
+ * @param  stack  Encounter stack to draw from
+ * @param  draws  Number of cards drawn, clamped to the cards left in the stack and ENCOUNTER_ODDS_MAX_DRAWS
+ * @return        The odds, which must not be freed
  */
-void replace_alien_cards()
+const encounter_odds *get_encounter_odds(const encounter_stack *stack, int draws)
 {
-    for (int i = 0; i < ENCOUNTER_STACK_SIZE - num_encounters; i++) {
-        if (discard_encounters[i] >= ALIEN_Lost_The_Signal && discard_encounters[i] <= ALIEN_Hunt) {
-            replace_card(i);
-            i--;
+    pthread_once(&encounter_tables_once, _init_encounter_tables);
+
+    draws = max(0, min(draws, min(stack->num_encounters, ENCOUNTER_ODDS_MAX_DRAWS)));
+
+    int makeup = 0;
+    for (int type = 0; type < NUM_ENCOUNTER_TYPES; type++) {
+        makeup += stack->remaining[type] * encounter_makeup_radix[type];
+    }
+
+    encounter_odds *odds = atomic_load(&encounter_odds_cache[makeup][draws]);
+    if (odds == NULL) {
+        encounter_odds *computed = (encounter_odds *)malloc(sizeof(encounter_odds));
+        _compute_encounter_odds(stack, draws, computed);
+
+        // If another thread got there first, its odds are the same, and odds is set to them
+        if (atomic_compare_exchange_strong(&encounter_odds_cache[makeup][draws], &odds, computed)) {
+            odds = computed;
+        } else {
+            free(computed);
         }
     }
-    shuffle_encounters();
+
+    return odds;
+}
+
+/**
+ * Exact chance that at least one alien card is among the next draws. Passing the number of cards left in the
+ * stack gives the chance of drawing one before the stack runs out. See get_encounter_odds
+ * @param stack  Encounter stack to draw from
+ * @param draws  Number of cards drawn, clamped to the cards left in the stack
+ * @return       Chance from 0 to 1
+ */
+double alien_encounter_chance(const encounter_stack *stack, int draws)
+{
+    pthread_once(&encounter_tables_once, _init_encounter_tables);
+
+    int left = stack->num_encounters;
+    draws = max(0, min(draws, left));
+
+    int aliens, order937s;
+    _count_encounter_classes(stack->remaining, &aliens, &order937s);
+
+    // One minus the chance that every card drawn is one of the others
+    return 1 - encounter_binomials[left - aliens][draws] / encounter_binomials[left][draws];
 }
 
 /**
- * Replaces all order937 cards in discard_encounters
+ * Exact chance that at least one card of a type is among the next draws. See get_encounter_odds
+ * @param stack      Encounter stack to draw from
+ * @param encounter  Type of the card
+ * @param draws      Number of cards drawn, clamped to the cards left in the stack
+ * @return           Chance from 0 to 1
  */
-void replace_order937_cards()
+double encounter_type_chance(const encounter_stack *stack, ENCOUNTER_TYPES encounter, int draws)
 {
-    for (int i = 0; i < ENCOUNTER_STACK_SIZE - num_encounters; i++) {
-        if (discard_encounters[i] >= ORDER937_Meet_Me_In_The_Infirmary &&
-            discard_encounters[i] <= ORDER937_Collating_Data) {
-            replace_card(i);
-            i--;
+    pthread_once(&encounter_tables_once, _init_encounter_tables);
+
+    int left = stack->num_encounters;
+    draws = max(0, min(draws, left));
+
+    return 1 - encounter_binomials[left - stack->remaining[encounter]][draws] / encounter_binomials[left][draws];
+}
+
+/**
+ * Put every discarded card with a type from first to last back in the stack, then shuffle it
+ * @param stack  Encounter stack to refill
+ * @param first  First type to replace
+ * @param last   Last type to replace
+ * @param rng    Generator to shuffle with
+ */
+void _replace_encounters(encounter_stack *stack, ENCOUNTER_TYPES first, ENCOUNTER_TYPES last, random_state *rng)
+{
+    for (int type = first; type <= last; type++) {
+        for (int i = 0; i < stack->discarded[type]; i++) {
+            stack->encounters[stack->num_encounters++] = type;
         }
+        stack->remaining[type] += stack->discarded[type];
+        stack->discarded[type] = 0;
     }
-    shuffle_encounters();
+    shuffle_encounters(stack, rng);
+}
+
+/**
+ * Put all encounter cards back in the stack
+ * @param stack  Encounter stack to refill
+ * @param rng    Generator to shuffle with
+ */
+void replace_all_encounters(encounter_stack *stack, random_state *rng)
+{
+    _replace_encounters(stack, QUIET, ORDER937_Collating_Data, rng);
+}
+
+/**
+ * Replaces all alien cards in the discard pile
+ * @param stack  Encounter stack to replace the cards in
+ * @param rng    Generator to shuffle with
+ */
+void replace_alien_cards(encounter_stack *stack, random_state *rng)
+{
+    _replace_encounters(stack, ALIEN_Lost_The_Signal, ALIEN_Hunt, rng);
+}
+
+/**
+ * Replaces all order937 cards in the discard pile
+ * @param stack  Encounter stack to replace the cards in
+ * @param rng    Generator to shuffle with
+ */
+void replace_order937_cards(encounter_stack *stack, random_state *rng)
+{
+    _replace_encounters(stack, ORDER937_Meet_Me_In_The_Infirmary, ORDER937_Collating_Data, rng);
 }
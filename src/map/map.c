@@ -5,15 +5,67 @@
  * @brief Logic for maps, including map file processing
 */
 
+#include <errno.h>
+#include <stdarg.h>
+
+#include "map/compiled_map.h"
 #include "map/map.h"
 
+/**
+ * Hash a room name for the map's room index (32-bit FNV-1a)
+ * @param  room_name               Name to hash
+ * @return           Hash of `room_name`
+ */
+unsigned int hash_room_name(const char *room_name)
+{
+    unsigned int hash = 2166136261u;
+    for (const char *c = room_name; *c != '\0'; c++) {
+        hash ^= (unsigned char)*c;
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+/**
+ * Add a room to the map's name index, growing the index to keep it at most half full
+ * @param game_map  Map to add to
+ * @param r         Room to index, already stored in game_map->rooms
+ */
+void index_room(map *game_map, room *r)
+{
+    if (2 * game_map->room_count > game_map->room_index_capacity) {
+        int capacity = game_map->room_index_capacity > 0 ? game_map->room_index_capacity * 2 : 64;
+        game_map->room_index = (room_id *)realloc(game_map->room_index, sizeof(room_id) * capacity);
+        game_map->room_index_capacity = capacity;
+
+        // Reinsert every room already read
+        for (int i = 0; i < capacity; i++) {
+            game_map->room_index[i] = NO_ROOM;
+        }
+        for (int i = 0; i < game_map->room_count; i++) {
+            if (game_map->rooms[i] != r) {
+                index_room(game_map, game_map->rooms[i]);
+            }
+        }
+    }
+
+    unsigned int mask = game_map->room_index_capacity - 1;
+    unsigned int slot = hash_room_name(r->name) & mask;
+    while (game_map->room_index[slot] != NO_ROOM) {
+        slot = (slot + 1) & mask;
+    }
+
+    game_map->room_index[slot] = r->id;
+}
+
 /**
  * Retrieves the room pointer corresponding to a given room name
  * @param  game_map                Map to look in
  * @param  room_name               Name of room to look for
  * @return           Pointer to room struct with name `room_name`
  */
-room *get_room(map *game_map, const char *room_name)
+room *get_room(const map *game_map, const char *room_name)
 {
     int index = get_room_index(game_map, room_name);
     if (index >= 0) {
@@ -27,25 +79,50 @@ room *get_room(map *game_map, const char *room_name)
  * Retrieves the room index corresponding to a given room name
  * @param  game_map                Map to look in
  * @param  room_name               Name of room to look for
- * @return           Index of room in game_map->rooms
+ * @return           Index of room in game_map->rooms, -1 if there is no such room
  */
-int get_room_index(map *game_map, const char *room_name)
+int get_room_index(const map *game_map, const char *room_name)
 {
-    for (int i = 0; i < game_map->room_count; i++) {
-        if (strcmp(game_map->rooms[i]->name, room_name) == 0) {
-            return i;
+    if (game_map->room_index_capacity == 0) {
+        return -1;
+    }
+
+    unsigned int mask = game_map->room_index_capacity - 1;
+    for (unsigned int slot = hash_room_name(room_name) & mask; game_map->room_index[slot] != NO_ROOM;
+         slot = (slot + 1) & mask) {
+        room_id id = game_map->room_index[slot];
+        if (strcmp(game_map->rooms[id]->name, room_name) == 0) {
+            return id;
         }
     }
 
     return -1;
 }
 
+/**
+ * Append a room pointer to a growable array, doubling its capacity when full
+ * @param list      Array to append to, reallocated if it is full
+ * @param count     Number of pointers in the array, incremented
+ * @param capacity  Number of pointers the array has space for
+ * @param r         Room to append
+ */
+void _append_room_pointer(room ***list, int *count, int *capacity, room *r)
+{
+    if (*count == *capacity) {
+        *capacity = *capacity > 0 ? *capacity * 2 : 64;
+        *list = (room **)realloc(*list, sizeof(room *) * *capacity);
+    }
+
+    (*list)[(*count)++] = r;
+}
+
 /**
  * Creates a new room with name `room_name` and adds it to `game_map` if another with the same
  * name does not exist
  * @param  room_name               Name of room to create
  * @param  game_map                Map to add room to
- * @return           Pointer to new room, or existing room if room with name `room_name` exists
+ * @return           Pointer to new room, or existing room if room with name `room_name` exists. NULL if
+ *                   the room doesn't exist and the map already has the most rooms a map can have
  */
 room *add_room_if_not_exists(map *game_map, char *room_name)
 {
@@ -74,9 +151,14 @@ room *add_room_if_not_exists(map *game_map, char *room_name)
         return already_exists_check;
     }
 
+    if (game_map->room_count == NO_ROOM) {
+        return NULL;
+    }
+
     room *new_room = create_room(room_name, 0);
-    game_map->rooms[game_map->room_count] = new_room;
-    game_map->room_count++;
+    new_room->id = game_map->room_count;
+    _append_room_pointer(&game_map->rooms, &game_map->room_count, &game_map->room_capacity, new_room);
+    index_room(game_map, new_room);
 
     if (is_player_start) {
         game_map->player_start_room = new_room;
@@ -90,274 +172,1078 @@ room *add_room_if_not_exists(map *game_map, char *room_name)
 }
 
 /**
- * Reset the search parameters of a map to prepare for a search
- * @param game_map  Map whose rooms' search parameters will be reset
- * @param distance  Distance to set room->search_distance to. Djikstra uses INT_MAX, DFS
- *                  uses -1
+ * Record a connection between two rooms while reading a map
+ * @param connections  List of connections read so far
+ * @param a            First room
+ * @param b            Second room
  */
-void reset_search(map *game_map, int distance)
+void add_connection(connection_list *connections, room *a, room *b)
 {
-    for (int i = 0; i < game_map->room_count; i++) {
-        game_map->rooms[i]->search_distance = distance;
-        game_map->rooms[i]->search_discovered = false;
-        game_map->rooms[i]->search_previous_room = NULL;
+    if (connections->count == connections->capacity) {
+        connections->capacity = connections->capacity > 0 ? connections->capacity * 2 : 64;
+        connections->from = (room_id *)realloc(connections->from, sizeof(room_id) * connections->capacity);
+        connections->to = (room_id *)realloc(connections->to, sizeof(room_id) * connections->capacity);
     }
+
+    connections->from[connections->count] = a->id;
+    connections->to[connections->count] = b->id;
+    connections->count++;
 }
 
 /**
- * A modified BFS that computes room distances from start_room
- * @param start_room  Room to start search from
- * @param distance    Distance at which to look for rooms
+ * Append `neighbor` to the adjacency row being filled for a room unless it is already in it
+ * @param adjacency  Adjacency array being filled
+ * @param row_start  Index of the first entry of the row
+ * @param row_end    Index one past the last filled entry of the row, advanced if `neighbor` is added
+ * @param neighbor   Room to add to the row
  */
-void _find_rooms_by_distance_recurse(room *start_room, int distance)
+void _append_unique(room_id *adjacency, int row_start, int *row_end, room_id neighbor)
 {
-    room_queue *q = new_room_queue(64);
+    for (int i = row_start; i < *row_end; i++) {
+        if (adjacency[i] == neighbor) {
+            return;
+        }
+    }
+
+    adjacency[(*row_end)++] = neighbor;
+}
 
-    start_room->search_distance = 0;
-    start_room->search_discovered = true;
+/**
+ * Compress a map's connections and ladders into its adjacency arrays
+ * @param game_map     Map whose rooms have all been read
+ * @param connections  Connections read from the map file, in file order
+ */
+void build_adjacency(map *game_map, const connection_list *connections)
+{
+    int n = game_map->room_count;
 
-    push(q, start_room);
+    // Reserve room for both directions of every connection, plus the ladder at the end of each row
+    int *row_start = (int *)calloc(n + 1, sizeof(int));
+    for (int i = 0; i < connections->count; i++) {
+        row_start[connections->from[i] + 1]++;
+        row_start[connections->to[i] + 1]++;
+    }
+    for (int i = 0; i < n; i++) {
+        row_start[i + 1] += row_start[i] + (game_map->rooms[i]->ladder_connection != NULL);
+    }
 
-    while (q->size > 0) {
-        room *v = pop(q);
+    room_id *adjacency = (room_id *)malloc(sizeof(room_id) * max(row_start[n], 1));
+    int *row_end = (int *)malloc(sizeof(int) * n);
+    for (int i = 0; i < n; i++) {
+        row_end[i] = row_start[i];
+    }
 
-        for (int i = 0; i < v->connection_count; i++) {
-            if (!v->connections[i]->search_discovered) {
-                v->connections[i]->search_distance = v->search_distance + 1;
-                v->connections[i]->search_discovered = true;
-                push(q, v->connections[i]);
-            }
-        }
+    // Connections may be listed by both of their rooms, so skip repeats
+    for (int i = 0; i < connections->count; i++) {
+        room_id a = connections->from[i];
+        room_id b = connections->to[i];
+        _append_unique(adjacency, row_start[a], &row_end[a], b);
+        _append_unique(adjacency, row_start[b], &row_end[b], a);
+    }
 
-        if (v->ladder_connection != NULL && !v->ladder_connection->search_discovered) {
-            v->ladder_connection->search_distance = v->search_distance + 1;
-            v->ladder_connection->search_discovered = true;
-            push(q, v->ladder_connection);
+    // Close the gaps left by repeats and add the ladders
+    game_map->adjacency_offsets = (int *)malloc(sizeof(int) * (n + 1));
+    int next = 0;
+    for (int i = 0; i < n; i++) {
+        game_map->adjacency_offsets[i] = next;
+        for (int j = row_start[i]; j < row_end[i]; j++) {
+            adjacency[next++] = adjacency[j];
+        }
+        if (game_map->rooms[i]->ladder_connection != NULL) {
+            adjacency[next++] = game_map->rooms[i]->ladder_connection->id;
         }
     }
+    game_map->adjacency_offsets[n] = next;
+    game_map->adjacency = adjacency;
+
+    free(row_start);
+    free(row_end);
+}
+
+/**
+ * Get the number of corridor connections of a room, not counting its ladder
+ * @param  game_map               Map containing the room
+ * @param  r                      Room to look at
+ * @return          Number of connections
+ */
+int room_connection_count(const map *game_map, const room *r)
+{
+    return game_map->adjacency_offsets[r->id + 1] - game_map->adjacency_offsets[r->id] -
+           (r->ladder_connection != NULL);
+}
+
+/**
+ * Get one of the corridor connections of a room
+ * @param  game_map               Map containing the room
+ * @param  r                      Room to look at
+ * @param  i                      Index of the connection, less than room_connection_count(game_map, r)
+ * @return          The connected room
+ */
+room *room_connection(const map *game_map, const room *r, int i)
+{
+    return game_map->rooms[game_map->adjacency[game_map->adjacency_offsets[r->id] + i]];
+}
+
+/**
+ * Bytes of arena memory alloc_search_scratch takes for a map
+ * @param  game_map               Map that will be searched
+ * @return          Size in bytes
+ */
+size_t search_scratch_size(const map *game_map)
+{
+    int n = game_map->room_count;
+
+    return ARENA_SIZE(sizeof(search_scratch)) + ARENA_SIZE(sizeof(unsigned int) * n) + 3 * ARENA_SIZE(sizeof(int) * n) +
+           ARENA_SIZE(room_queue_size(n)) + ARENA_SIZE(sizeof(bool) * n) + ARENA_SIZE(sizeof(room *) * n);
+}
+
+/**
+ * Allocate working memory for searches over a map from an arena, the search_scratch structure first
+ * @param  game_map               Map that will be searched
+ * @param  memory                 Arena with search_scratch_size(game_map) bytes free
+ * @return          Pointer to scratch space sized for `game_map`
+ */
+search_scratch *alloc_search_scratch(const map *game_map, arena *memory)
+{
+    search_scratch *scratch = (search_scratch *)arena_alloc(memory, sizeof(search_scratch));
+
+    scratch->capacity = game_map->room_count;
+    scratch->epoch = 0;
+    scratch->visited = (unsigned int *)arena_alloc(memory, sizeof(unsigned int) * scratch->capacity);
+    memset(scratch->visited, 0, sizeof(unsigned int) * scratch->capacity);
+    scratch->distance = (int *)arena_alloc(memory, sizeof(int) * scratch->capacity);
+    scratch->origin = (int *)arena_alloc(memory, sizeof(int) * scratch->capacity);
+    scratch->previous = (int *)arena_alloc(memory, sizeof(int) * scratch->capacity);
+    scratch->frontier = init_room_queue(arena_alloc(memory, room_queue_size(scratch->capacity)), scratch->capacity);
+    scratch->targets = (bool *)arena_alloc(memory, sizeof(bool) * scratch->capacity);
+    memset(scratch->targets, 0, sizeof(bool) * scratch->capacity);
+    scratch->result_count = 0;
+    scratch->results = (room **)arena_alloc(memory, sizeof(room *) * scratch->capacity);
+
+    return scratch;
+}
+
+/**
+ * Allocate working memory for searches over a map, in one allocation
+ * @param  game_map               Map that will be searched
+ * @return          Pointer to scratch space sized for `game_map`
+ */
+search_scratch *new_search_scratch(const map *game_map)
+{
+    size_t size = search_scratch_size(game_map);
+    arena memory;
+    init_arena(&memory, malloc(size), size);
+
+    return alloc_search_scratch(game_map, &memory);
+}
+
+/**
+ * Free search working memory made by new_search_scratch
+ * @param scratch  Scratch space to free
+ */
+void free_search_scratch(search_scratch *scratch)
+{
+    // The structure is at the start of its allocation
+    free(scratch);
+}
+
+/**
+ * Start a new search, invalidating every room visited by the previous one without touching them
+ * @param scratch  Scratch space to reuse
+ */
+void begin_search(search_scratch *scratch)
+{
+    scratch->epoch++;
+
+    // The counter wrapped, so old marks could collide with the new epoch
+    if (scratch->epoch == 0) {
+        memset(scratch->visited, 0, sizeof(unsigned int) * scratch->capacity);
+        scratch->epoch = 1;
+    }
+}
+
+/**
+ * Reset the target flags of a scratch space so a new set of targets can be marked
+ * @param  scratch                Scratch space to reuse
+ * @return         scratch->targets, with every room unmarked
+ */
+bool *clear_targets(search_scratch *scratch)
+{
+    memset(scratch->targets, 0, sizeof(bool) * scratch->capacity);
+
+    return scratch->targets;
 }
 
 /**
  * Finds rooms within or exactly of a certain distance from a provided starting room
+ * Matching rooms are stored in `scratch->results` in room index order
  * @param  game_map                 Map to search in
  * @param  start_room               Room to start searching from
  * @param  distance                 Distance to search up to or exactly to
  * @param  inclusive                If true, results will include rooms up to `distance` edges away
- * @return            A pointer to a room_queue object of the matching rooms
+ * @param  scratch                  Caller-owned working memory for the search
+ * @return            The number of matching rooms
  */
-room_queue *find_rooms_by_distance(map *game_map, room *start_room, int distance, bool inclusive)
+int find_rooms_by_distance(const map *game_map,
+                           const room *start_room,
+                           int distance,
+                           bool inclusive,
+                           search_scratch *scratch)
 {
-    struct room_queue *results = new_room_queue(64);
+    // Small maps have these sets precomputed, and set bits are already in index order
+    if (game_map->rooms_at_distance != NULL && distance >= 0 && distance <= MAX_RING_DISTANCE) {
+        scratch->result_count = 0;
+        for (room_set set = rooms_by_distance(game_map, start_room, distance, inclusive); set != 0; set &= set - 1) {
+            scratch->results[scratch->result_count++] = game_map->rooms[room_set_first(set)];
+        }
 
-    reset_search(game_map, INT_MAX);
+        return scratch->result_count;
+    }
 
-    _find_rooms_by_distance_recurse(start_room, 0);
+    begin_search(scratch);
 
-    for (int i = 0; i < game_map->room_count; i++) {
-        if (game_map->rooms[i]->search_distance == distance ||
-            (inclusive && game_map->rooms[i]->search_distance <= distance)) {
-            push(results, game_map->rooms[i]);
+    room_queue *frontier = scratch->frontier;
+    clear_queue(frontier);
+
+    scratch->visited[start_room->id] = scratch->epoch;
+    scratch->distance[start_room->id] = 0;
+    push(frontier, game_map->rooms[start_room->id]);
+    scratch->result_count = 0;
+
+    while (frontier->size > 0) {
+        int v = pop(frontier)->id;
+        int v_distance = scratch->distance[v];
+
+        if (v_distance == distance || (inclusive && v_distance <= distance)) {
+            // Insert in index order so menus list rooms the same way every time
+            int j = scratch->result_count++;
+            while (j > 0 && scratch->results[j - 1]->id > v) {
+                scratch->results[j] = scratch->results[j - 1];
+                j--;
+            }
+            scratch->results[j] = game_map->rooms[v];
+        }
+
+        // Rooms past `distance` can't match, so don't expand beyond it
+        if (v_distance == distance) {
+            continue;
         }
+
+        for (int e = game_map->adjacency_offsets[v]; e < game_map->adjacency_offsets[v + 1]; e++) {
+            int neighbor = game_map->adjacency[e];
+            if (scratch->visited[neighbor] == scratch->epoch) {
+                continue;
+            }
+
+            scratch->visited[neighbor] = scratch->epoch;
+            scratch->distance[neighbor] = v_distance + 1;
+            push(frontier, game_map->rooms[neighbor]);
+        }
+    }
+
+    return scratch->result_count;
+}
+
+/**
+ * Fill in the distance and next hop tables of a map with a BFS from every room
+ * @param game_map  Map whose tables will be built
+ */
+void build_path_tables(map *game_map)
+{
+    int n = game_map->room_count;
+
+    game_map->distances = NULL;
+    game_map->next_hop = NULL;
+    if (n > MAX_PATH_TABLE_ROOMS) {
+        return;
     }
 
-    reset_search(game_map, -1);
+    game_map->distances = (unsigned char *)malloc(n * n);
+    game_map->next_hop = (unsigned char *)malloc(n * n);
+    memset(game_map->distances, UNREACHABLE_DISTANCE, n * n);
+    memset(game_map->next_hop, 0, n * n);
+
+    int *queue = (int *)malloc(sizeof(int) * n);
+    for (int source = 0; source < n; source++) {
+        unsigned char *distance = &game_map->distances[source * n];
+        unsigned char *hop = &game_map->next_hop[source * n];
+
+        distance[source] = 0;
+        hop[source] = source;
+
+        int head = 0;
+        int tail = 0;
+        queue[tail++] = source;
+
+        while (head < tail) {
+            int v = queue[head++];
+
+            for (int e = game_map->adjacency_offsets[v]; e < game_map->adjacency_offsets[v + 1]; e++) {
+                int neighbor = game_map->adjacency[e];
+                if (distance[neighbor] != UNREACHABLE_DISTANCE) {
+                    continue;
+                }
+
+                distance[neighbor] = distance[v] + 1;
+                // Rooms next to the source are their own first step, everything else inherits one
+                hop[neighbor] = v == source ? neighbor : hop[v];
+                queue[tail++] = neighbor;
+            }
+        }
+    }
 
-    return results;
+    free(queue);
 }
 
 /**
- * Reads in a map from a map file
- * @param  fn               Filename of map file
- * @return    Pointer to new map
+ * Fill in the sets of rooms at and within each distance up to MAX_RING_DISTANCE of every room
+ * Needs the distance table, and is skipped for maps too large for a room_set
+ * @param game_map  Map whose sets will be built
  */
-map *read_map(const char *fn)
+void build_distance_rings(map *game_map)
 {
-    // Allocate space for map
-    map *new_map = (map *)malloc(sizeof(map));
+    int n = game_map->room_count;
 
-    // Open map definition file
-    FILE *fp;
-    fp = fopen(fn, "r");
-    if (fp == NULL) {
-        fprintf(stderr, "[ERROR] - Failed to open map file %s\n", fn);
-        exit(1);
+    game_map->rooms_at_distance = NULL;
+    game_map->rooms_within_distance = NULL;
+    if (n > 64) {
+        return;
     }
 
-    // Read map name
-    fgets(new_map->name, 31, fp);
-    strip_string(new_map->name, strlen(new_map->name));
+    game_map->rooms_at_distance = (room_set *)calloc(n * (MAX_RING_DISTANCE + 1), sizeof(room_set));
+    game_map->rooms_within_distance = (room_set *)calloc(n * (MAX_RING_DISTANCE + 1), sizeof(room_set));
 
-    // Read rooms
-    int fscanf_code;
-    int scanning_scrap_events_coolant = 0;
-    int scanning_ascii_map = 0;
-    char line[256];
+    for (int i = 0; i < n; i++) {
+        room_set *at = &game_map->rooms_at_distance[i * (MAX_RING_DISTANCE + 1)];
+        room_set *within = &game_map->rooms_within_distance[i * (MAX_RING_DISTANCE + 1)];
 
-    new_map->player_start_room = NULL;
-    new_map->xenomorph_start_room = NULL;
-    new_map->ash_start_room = NULL;
+        for (int j = 0; j < n; j++) {
+            int d = game_map->distances[i * n + j];
+            if (d <= MAX_RING_DISTANCE) {
+                at[d] = room_set_add(at[d], j);
+            }
+        }
 
-    new_map->scrap_room_count = 0;
-    new_map->event_room_count = 0;
-    new_map->coolant_room_count = 0;
+        within[0] = at[0];
+        for (int k = 1; k <= MAX_RING_DISTANCE; k++) {
+            within[k] = within[k - 1] | at[k];
+        }
+    }
+}
 
-    new_map->room_count = 0;
-    new_map->named_room_count = 0;
+/**
+ * Look up the precomputed set of rooms at or within a distance of a room
+ * @param  game_map                 Map with distance rings, see build_distance_rings
+ * @param  start_room               Room to measure from
+ * @param  distance                 Distance in [0, MAX_RING_DISTANCE]
+ * @param  inclusive                If true, the set includes rooms up to `distance` edges away
+ * @return            The set of matching rooms
+ */
+room_set rooms_by_distance(const map *game_map, const room *start_room, int distance, bool inclusive)
+{
+    int index = start_room->id * (MAX_RING_DISTANCE + 1) + distance;
 
-    new_map->ascii_map = "";
+    return inclusive ? game_map->rooms_within_distance[index] : game_map->rooms_at_distance[index];
+}
 
-    while (fgets(line, 255, fp)) {
-        // Section checking
-        if (line[0] == '~') {
-            if (scanning_scrap_events_coolant == 0) {
-                scanning_scrap_events_coolant = 1;
-                continue;
-            } else if (scanning_scrap_events_coolant > 0 && scanning_scrap_events_coolant < 4) {
-                scanning_scrap_events_coolant = 4;
-                continue;
-            } else if (scanning_ascii_map == 0) {
-                scanning_ascii_map = 1;
-                new_map->ascii_map = (char *)malloc(2048);
-                new_map->ascii_map[0] = '\0';
-                continue;
-            } else if (scanning_ascii_map == 1) {
-                scanning_ascii_map = 2;
+/**
+ * BFS backwards from `to` until `from` is reached, for maps without shortest path tables
+ * Afterwards scratch->distance[from->id] is the length of a shortest path and scratch->previous[from->id]
+ * is the first room on it
+ * @param  game_map               Map containing both rooms
+ * @param  from                   Room to start from
+ * @param  to                     Room to end at
+ * @param  scratch                Caller-owned working memory for the search
+ * @return          True if `to` can be reached from `from`
+ */
+bool _search_towards(const map *game_map, const room *from, const room *to, search_scratch *scratch)
+{
+    begin_search(scratch);
+
+    room_queue *frontier = scratch->frontier;
+    clear_queue(frontier);
+
+    scratch->visited[to->id] = scratch->epoch;
+    scratch->distance[to->id] = 0;
+    scratch->previous[to->id] = to->id;
+    push(frontier, game_map->rooms[to->id]);
+
+    while (frontier->size > 0) {
+        int v = pop(frontier)->id;
+        if (v == from->id) {
+            return true;
+        }
+
+        for (int e = game_map->adjacency_offsets[v]; e < game_map->adjacency_offsets[v + 1]; e++) {
+            int neighbor = game_map->adjacency[e];
+            if (scratch->visited[neighbor] == scratch->epoch) {
                 continue;
             }
+
+            scratch->visited[neighbor] = scratch->epoch;
+            scratch->distance[neighbor] = scratch->distance[v] + 1;
+            scratch->previous[neighbor] = v;
+            push(frontier, game_map->rooms[neighbor]);
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Look up the number of edges on a shortest path between two rooms
+ * @param  game_map               Map containing both rooms
+ * @param  from                   Room to start from
+ * @param  to                     Room to end at
+ * @param  scratch                Working memory for maps too large for path tables
+ * @return          Length of the shortest path, INT_MAX if `to` can't be reached from `from`
+ */
+int room_distance(const map *game_map, const room *from, const room *to, search_scratch *scratch)
+{
+    if (game_map->distances == NULL) {
+        return _search_towards(game_map, from, to, scratch) ? scratch->distance[from->id] : INT_MAX;
+    }
+
+    unsigned char distance = game_map->distances[from->id * game_map->room_count + to->id];
+
+    return distance == UNREACHABLE_DISTANCE ? INT_MAX : distance;
+}
+
+/**
+ * Look up the first room on a shortest path between two rooms
+ * @param  game_map               Map containing both rooms
+ * @param  from                   Room to start from
+ * @param  to                     Room to end at
+ * @param  scratch                Working memory for maps too large for path tables
+ * @return          Room one step closer to `to`, or `from` if the rooms are the same or unconnected
+ */
+room *next_room_towards(const map *game_map, const room *from, const room *to, search_scratch *scratch)
+{
+    if (game_map->distances == NULL) {
+        if (!_search_towards(game_map, from, to, scratch)) {
+            return game_map->rooms[from->id];
         }
 
-        // Scrap, Events, Coolant scanning
-        if (scanning_scrap_events_coolant > 0 && scanning_scrap_events_coolant < 4) {
-            char *columns = strtok(line, ";");
-            while (columns) {
-                if (columns[0] == '\n') {
-                    break;
-                }
+        return game_map->rooms[scratch->previous[from->id]];
+    }
 
-                room *found_room = get_room(new_map, columns);
-                if (found_room == NULL) {
-                    fprintf(stderr, "[ERROR] - Room %s not recognized\n", columns);
-                    exit(1);
-                }
+    int index = from->id * game_map->room_count + to->id;
+    if (game_map->distances[index] == UNREACHABLE_DISTANCE) {
+        return game_map->rooms[from->id];
+    }
 
-                switch (scanning_scrap_events_coolant) {
-                case 1:
-                    new_map->scrap_rooms[new_map->scrap_room_count++] = found_room;
-                    break;
-                case 2:
-                    new_map->event_rooms[new_map->event_room_count++] = found_room;
-                    break;
-                case 3:
-                    new_map->coolant_rooms[new_map->coolant_room_count++] = found_room;
-                    break;
-                default:
-                    fprintf(stderr, "[ERROR] - Something went wrong scanning for special rooms\n");
-                    exit(1);
-                    break;
-                }
+    return game_map->rooms[game_map->next_hop[index]];
+}
 
-                columns = strtok(NULL, ";");
+/**
+ * Find the target room closest to `source` with a single BFS seeded from every target at once
+ * Ties are broken by BFS discovery order, with targets seeded in ascending room index order
+ * @param  game_map                 Map to search in
+ * @param  source                   Room to measure distances from
+ * @param  targets                  Array indexed by room id, true for rooms that may be picked
+ * @param  scratch                  Caller-owned working memory for the search
+ * @param  distance                 Set to the number of edges between `source` and the nearest target
+ * @param  first_step               Set to the first room on the path from `source` to the nearest target,
+ *                                  or `source` if it is a target itself
+ * @return            The nearest target room, NULL if no target can be reached
+ */
+room *find_nearest_room(const map *game_map,
+                        const room *source,
+                        const bool *targets,
+                        search_scratch *scratch,
+                        int *distance,
+                        room **first_step)
+{
+    begin_search(scratch);
+
+    room_queue *frontier = scratch->frontier;
+    clear_queue(frontier);
+
+    for (int i = 0; i < game_map->room_count; i++) {
+        if (targets[i]) {
+            scratch->visited[i] = scratch->epoch;
+            scratch->distance[i] = 0;
+            scratch->origin[i] = i;
+            scratch->previous[i] = i;
+            push(frontier, game_map->rooms[i]);
+        }
+    }
+
+    while (frontier->size > 0) {
+        int v = pop(frontier)->id;
+        if (v == source->id) {
+            break;
+        }
+
+        for (int e = game_map->adjacency_offsets[v]; e < game_map->adjacency_offsets[v + 1]; e++) {
+            int neighbor = game_map->adjacency[e];
+            if (scratch->visited[neighbor] == scratch->epoch) {
+                continue;
             }
-            scanning_scrap_events_coolant++;
-        } else if (scanning_ascii_map) {
-            strcat(new_map->ascii_map, line);
-            continue;
+
+            scratch->visited[neighbor] = scratch->epoch;
+            scratch->distance[neighbor] = scratch->distance[v] + 1;
+            scratch->origin[neighbor] = scratch->origin[v];
+            scratch->previous[neighbor] = v;
+            push(frontier, game_map->rooms[neighbor]);
         }
+    }
 
-        // Get line separated by semicolons
-        char *columns = strtok(line, ";");
-        int column_index = 0;
+    if (scratch->visited[source->id] != scratch->epoch) {
+        return NULL;
+    }
 
-        room *target_room = NULL;
+    // The search ran from the targets towards the source, so the source's predecessor is its first step
+    *distance = scratch->distance[source->id];
+    if (first_step != NULL) {
+        *first_step = game_map->rooms[scratch->previous[source->id]];
+    }
 
-        // For each entry in the row
-        while (columns) {
-            // Strip trailing whitespace
-            strip_string(columns, strlen(columns));
+    return game_map->rooms[scratch->origin[source->id]];
+}
 
-            if (column_index == 0) {
-                // Named room
-                if (is_letter(columns[0]) || columns[0] == '&' || columns[0] == '*' || columns[0] == '$') {
-                    target_room = add_room_if_not_exists(new_map, columns);
-                    new_map->named_room_indices[new_map->named_room_count++] =
-                        get_room_index(new_map, target_room->name);
-                }
-                // Chained corridors
-                else if (is_number(columns[0])) {
-                    char corridor_name[32] = "Corridor ";
-                    strcat(corridor_name, columns);
+// The parts of a map file, in the order they appear
+typedef enum {
+    MAP_SECTION_NAME,
+    MAP_SECTION_ROOMS,
+    MAP_SECTION_SPECIAL_ROOMS,
+    MAP_SECTION_ASCII_MAP,
+    MAP_SECTION_END
+} MAP_SECTION;
 
-                    target_room = get_room(new_map, corridor_name);
-                }
-                // Connections
-            } else {
-                // Corridors
-                if (is_number(columns[0])) {
-                    char new_corridor_name[32] = "Corridor ";
-                    strcat(new_corridor_name, columns);
-
-                    room *connected_corridor = add_room_if_not_exists(new_map, new_corridor_name);
-                    connected_corridor->is_corridor = true;
-
-                    add_connection(target_room, connected_corridor);
-                    // Rooms
-                } else if (is_letter(columns[0])) {
-                    room *connected_room = get_room(new_map, columns);
-                    add_connection(target_room, connected_room);
-                    // Ladder
-                } else if (columns[0] == '%') {
-                    room *ladder_room = add_room_if_not_exists(new_map, columns);
-
-                    target_room->ladder_connection = ladder_room;
-                    ladder_room->ladder_connection = target_room;
-                }
+// Everything a single read_map call needs while it works through a file. Nothing is shared between
+// calls, so any number of maps can be read at once
+typedef struct map_parser {
+    map *new_map;
+    // Connections read so far, compressed into adjacency once the file is read
+    connection_list connections;
+
+    MAP_SECTION section;
+    // Number of scrap, event, and coolant lines read
+    int special_rooms_read;
+
+    // Length of the ASCII map read so far and the size of its buffer
+    size_t ascii_map_length;
+    size_t ascii_map_capacity;
+
+    // Line being parsed, 1-based
+    int line_number;
+    map_error *error;
+} map_parser;
+
+/**
+ * Record a map error
+ * @param  error                  Error to fill in
+ * @param  line                   Line of the problem, 0 if it isn't tied to a line
+ * @param  column                 Column of the problem, 0 if it isn't tied to a column
+ * @param  format                 printf format string describing the problem
+ * @return        false, so parsers can `return map_error_at(...)`
+ */
+bool map_error_at(map_error *error, int line, int column, const char *format, ...)
+{
+    error->line = line;
+    error->column = column;
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(error->message, sizeof(error->message), format, args);
+    va_end(args);
+
+    return false;
+}
+
+/**
+ * Print a map error in the same format as the game's other errors
+ * @param fn     Filename of the map that failed to load
+ * @param error  The error
+ */
+void print_map_error(const char *fn, const map_error *error)
+{
+    if (error->line > 0 && error->column > 0) {
+        fprintf(stderr, "[ERROR] - %s:%d:%d: %s\n", fn, error->line, error->column, error->message);
+    } else if (error->line > 0) {
+        fprintf(stderr, "[ERROR] - %s:%d: %s\n", fn, error->line, error->message);
+    } else {
+        fprintf(stderr, "[ERROR] - %s: %s\n", fn, error->message);
+    }
+}
+
+/**
+ * Split the next semicolon-separated column off a line. Columns are stripped of trailing whitespace,
+ * and empty columns are skipped
+ * @param  cursor               Position in the line, advanced past the column
+ * @param  line                 Start of the line, to measure columns from
+ * @param  column               Set to the 1-based column the returned text starts at
+ * @return        The column's text, terminated in place, or NULL at the end of the line
+ */
+char *_next_column(char **cursor, const char *line, int *column)
+{
+    while (**cursor != '\0') {
+        char *start = *cursor;
+        char *end = start;
+        while (*end != '\0' && *end != ';') {
+            end++;
+        }
+
+        *cursor = *end == ';' ? end + 1 : end;
+        *end = '\0';
+        strip_string(start, end - start);
+
+        if (*start != '\0') {
+            *column = start - line + 1;
+            return start;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Check that a room name, not counting a leading marker character, fits in a room
+ * @param  parser                Parser state
+ * @param  name                  Room name as written in the file
+ * @param  column                Column the name starts at
+ * @return        True if the name fits
+ */
+bool _check_room_name(map_parser *parser, const char *name, int column)
+{
+    int marker = name[0] == '&' || name[0] == '*' || name[0] == '$' || name[0] == '%';
+    if (strlen(name) - marker > ROOM_NAME_LENGTH - 1) {
+        return map_error_at(parser->error,
+                            parser->line_number,
+                            column,
+                            "Room name \"%s\" is longer than %d characters",
+                            name + marker,
+                            ROOM_NAME_LENGTH - 1);
+    }
+
+    return true;
+}
+
+/**
+ * Turn a corridor number from a map file into the corridor's room name
+ * @param  parser                Parser state
+ * @param  number                Corridor number as written in the file
+ * @param  column                Column the number starts at
+ * @param  corridor_name         Filled in with the corridor's name
+ * @return        True if `number` is a valid corridor number
+ */
+bool _corridor_name(map_parser *parser, const char *number, int column, char corridor_name[ROOM_NAME_LENGTH])
+{
+    for (const char *c = number; *c != '\0'; c++) {
+        if (!is_number(*c)) {
+            return map_error_at(parser->error,
+                                parser->line_number,
+                                column + (c - number),
+                                "Corridor \"%s\" should be a number",
+                                number);
+        }
+    }
+
+    if (snprintf(corridor_name, ROOM_NAME_LENGTH, "Corridor %s", number) >= ROOM_NAME_LENGTH) {
+        return map_error_at(parser->error, parser->line_number, column, "Corridor number %s is too long", number);
+    }
+
+    return true;
+}
+
+/**
+ * Add a room to the map being read, reporting a full map as an error
+ * @param  parser                Parser state
+ * @param  name                  Room name, with its marker character if it has one
+ * @param  column                Column the name starts at
+ * @return        The new or existing room, NULL on error
+ */
+room *_add_room(map_parser *parser, char *name, int column)
+{
+    room *r = add_room_if_not_exists(parser->new_map, name);
+    if (r == NULL) {
+        map_error_at(parser->error,
+                     parser->line_number,
+                     column,
+                     "A map may have at most %d rooms and corridors",
+                     NO_ROOM);
+    }
+
+    return r;
+}
+
+/**
+ * Parse a line of the room section: a room or corridor followed by its connections
+ * @param  parser                Parser state
+ * @param  line                  Line to parse, modified in place
+ * @return        True on success
+ */
+bool _parse_room_line(map_parser *parser, char *line)
+{
+    map *new_map = parser->new_map;
+    char *cursor = line;
+    int column;
+
+    char *entry = _next_column(&cursor, line, &column);
+    if (entry == NULL) {
+        return true;
+    }
+
+    room *target_room = NULL;
+    char corridor_name[ROOM_NAME_LENGTH];
+
+    // Named room
+    if (is_letter(entry[0]) || entry[0] == '&' || entry[0] == '*' || entry[0] == '$') {
+        if (!_check_room_name(parser, entry, column) || (target_room = _add_room(parser, entry, column)) == NULL) {
+            return false;
+        }
+
+        if (new_map->named_room_count == new_map->named_room_capacity) {
+            new_map->named_room_capacity = new_map->named_room_capacity > 0 ? new_map->named_room_capacity * 2 : 64;
+            new_map->named_room_indices =
+                (int *)realloc(new_map->named_room_indices, sizeof(int) * new_map->named_room_capacity);
+        }
+        new_map->named_room_indices[new_map->named_room_count++] = target_room->id;
+    }
+    // Chained corridors
+    else if (is_number(entry[0])) {
+        if (!_corridor_name(parser, entry, column, corridor_name)) {
+            return false;
+        }
+
+        target_room = get_room(new_map, corridor_name);
+        if (target_room == NULL) {
+            return map_error_at(parser->error,
+                                parser->line_number,
+                                column,
+                                "Corridor %s is listed before anything connects to it",
+                                entry);
+        }
+    } else {
+        return map_error_at(
+            parser->error, parser->line_number, column, "Expected a room name or corridor number, got \"%s\"", entry);
+    }
+
+    // Connections
+    while ((entry = _next_column(&cursor, line, &column)) != NULL) {
+        // Corridors
+        if (is_number(entry[0])) {
+            if (!_corridor_name(parser, entry, column, corridor_name)) {
+                return false;
+            }
+
+            room *connected_corridor = _add_room(parser, corridor_name, column);
+            if (connected_corridor == NULL) {
+                return false;
+            }
+            connected_corridor->is_corridor = true;
+
+            add_connection(&parser->connections, target_room, connected_corridor);
+            // Rooms
+        } else if (is_letter(entry[0])) {
+            room *connected_room = get_room(new_map, entry);
+            if (connected_room == NULL) {
+                return map_error_at(parser->error,
+                                    parser->line_number,
+                                    column,
+                                    "Room \"%s\" is connected to before it is listed",
+                                    entry);
+            }
+
+            add_connection(&parser->connections, target_room, connected_room);
+            // Ladder
+        } else if (entry[0] == '%') {
+            room *ladder_room;
+            if (!_check_room_name(parser, entry, column) || (ladder_room = _add_room(parser, entry, column)) == NULL) {
+                return false;
             }
 
-            // Move to next entry
-            columns = strtok(NULL, ";");
-            column_index++;
+            target_room->ladder_connection = ladder_room;
+            ladder_room->ladder_connection = target_room;
+        } else {
+            return map_error_at(
+                parser->error, parser->line_number, column, "Expected a connection, got \"%s\"", entry);
         }
     }
 
-    if (new_map->player_start_room == NULL || new_map->xenomorph_start_room == NULL ||
-        new_map->ash_start_room == NULL) {
-        fprintf(stderr, "[ERROR] - Player, Xenomorph, and Ash start rooms must all be defined.");
-        exit(1);
+    return true;
+}
+
+/**
+ * Parse a line of the special room section: the rooms that start with scrap, events, or coolant
+ * @param  parser                Parser state
+ * @param  line                  Line to parse, modified in place
+ * @return        True on success
+ */
+bool _parse_special_room_line(map_parser *parser, char *line)
+{
+    map *new_map = parser->new_map;
+    char *cursor = line;
+    int column;
+
+    char *entry;
+    while ((entry = _next_column(&cursor, line, &column)) != NULL) {
+        room *found_room = get_room(new_map, entry);
+        if (found_room == NULL) {
+            return map_error_at(parser->error, parser->line_number, column, "Room \"%s\" not recognized", entry);
+        }
+
+        switch (parser->special_rooms_read) {
+        case 0:
+            _append_room_pointer(
+                &new_map->scrap_rooms, &new_map->scrap_room_count, &new_map->scrap_room_capacity, found_room);
+            break;
+        case 1:
+            _append_room_pointer(
+                &new_map->event_rooms, &new_map->event_room_count, &new_map->event_room_capacity, found_room);
+            break;
+        case 2:
+            _append_room_pointer(
+                &new_map->coolant_rooms, &new_map->coolant_room_count, &new_map->coolant_room_capacity, found_room);
+            break;
+        }
+    }
+
+    parser->special_rooms_read++;
+
+    return true;
+}
+
+/**
+ * Append a line to the ASCII map, doubling its buffer so reading it stays linear in its size
+ * @param parser       Parser state
+ * @param line         Line to append
+ * @param line_length  Length of `line`
+ */
+void _append_ascii_map_line(map_parser *parser, const char *line, size_t line_length)
+{
+    map *new_map = parser->new_map;
+
+    if (parser->ascii_map_length + line_length + 1 > parser->ascii_map_capacity) {
+        while (parser->ascii_map_length + line_length + 1 > parser->ascii_map_capacity) {
+            parser->ascii_map_capacity *= 2;
+        }
+        new_map->ascii_map = (char *)realloc(new_map->ascii_map, parser->ascii_map_capacity);
+    }
+
+    memcpy(new_map->ascii_map + parser->ascii_map_length, line, line_length + 1);
+    parser->ascii_map_length += line_length;
+}
+
+/**
+ * Check whether a line is empty apart from whitespace
+ * @param  line               Line to check
+ * @return      True if the line is blank
+ */
+bool _is_blank(const char *line)
+{
+    for (const char *c = line; *c != '\0'; c++) {
+        if (*c != ' ' && *c != '\t' && *c != '\n' && *c != '\r') {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Parse one line of a map file
+ * @param  parser                Parser state
+ * @param  line                  Line to parse, modified in place
+ * @param  line_length           Length of `line`
+ * @return        True on success
+ */
+bool _parse_map_line(map_parser *parser, char *line, size_t line_length)
+{
+    // Section separators
+    if (line[0] == '~' && parser->section != MAP_SECTION_NAME) {
+        switch (parser->section) {
+        case MAP_SECTION_ROOMS:
+            parser->section = MAP_SECTION_SPECIAL_ROOMS;
+            return true;
+        case MAP_SECTION_SPECIAL_ROOMS:
+            parser->section = MAP_SECTION_ASCII_MAP;
+            return true;
+        case MAP_SECTION_ASCII_MAP:
+            parser->section = MAP_SECTION_END;
+            return true;
+        default:
+            return map_error_at(parser->error, parser->line_number, 1, "Unexpected section after the ASCII map");
+        }
+    }
+
+    switch (parser->section) {
+    case MAP_SECTION_NAME:
+        strip_string(line, line_length);
+        if (strlen(line) > sizeof(parser->new_map->name) - 1) {
+            return map_error_at(parser->error,
+                                parser->line_number,
+                                sizeof(parser->new_map->name),
+                                "Map name is longer than %d characters",
+                                (int)sizeof(parser->new_map->name) - 1);
+        }
+        strcpy(parser->new_map->name, line);
+        parser->section = MAP_SECTION_ROOMS;
+        return true;
+    case MAP_SECTION_ROOMS:
+        return _parse_room_line(parser, line);
+    case MAP_SECTION_SPECIAL_ROOMS:
+        if (parser->special_rooms_read < 3) {
+            return _parse_special_room_line(parser, line);
+        } else if (!_is_blank(line)) {
+            return map_error_at(parser->error,
+                                parser->line_number,
+                                1,
+                                "Expected ~~~ after the scrap, event, and coolant rooms");
+        }
+        return true;
+    case MAP_SECTION_ASCII_MAP:
+        _append_ascii_map_line(parser, line, line_length);
+        return true;
+    default:
+        if (!_is_blank(line)) {
+            return map_error_at(parser->error, parser->line_number, 1, "Unexpected text after the ASCII map");
+        }
+        return true;
     }
+}
 
-    // Close map file
+/**
+ * Reads in a map from a map file in a single pass, or loads it if the file is a compiled map image
+ * @param  fn               Filename of map file
+ * @param  error            Filled in with the line, column, and reason if the map can't be read
+ * @return    Pointer to new map, NULL on error
+ */
+map *read_map(const char *fn, map_error *error)
+{
+    // Open map definition file
+    FILE *fp;
+    fp = fopen(fn, "r");
+    if (fp == NULL) {
+        map_error_at(error, 0, 0, "Failed to open map file: %s", strerror(errno));
+        return NULL;
+    }
+
+    if (is_compiled_map(fp)) {
+        fclose(fp);
+        return load_compiled_map(fn, error);
+    }
+
+    // Allocate space for map
+    map *new_map = (map *)malloc(sizeof(map));
+    new_map->name[0] = '\0';
+
+    new_map->player_start_room = NULL;
+    new_map->xenomorph_start_room = NULL;
+    new_map->ash_start_room = NULL;
+
+    new_map->scrap_room_count = 0;
+    new_map->scrap_room_capacity = 0;
+    new_map->scrap_rooms = NULL;
+    new_map->event_room_count = 0;
+    new_map->event_room_capacity = 0;
+    new_map->event_rooms = NULL;
+    new_map->coolant_room_count = 0;
+    new_map->coolant_room_capacity = 0;
+    new_map->coolant_rooms = NULL;
+
+    new_map->room_count = 0;
+    new_map->room_capacity = 0;
+    new_map->rooms = NULL;
+    new_map->named_room_count = 0;
+    new_map->named_room_capacity = 0;
+    new_map->named_room_indices = NULL;
+
+    new_map->room_index_capacity = 0;
+    new_map->room_index = NULL;
+
+    new_map->adjacency_offsets = NULL;
+    new_map->adjacency = NULL;
+    new_map->rooms_at_distance = NULL;
+    new_map->rooms_within_distance = NULL;
+    new_map->distances = NULL;
+    new_map->next_hop = NULL;
+
+    new_map->room_block = NULL;
+    new_map->image = NULL;
+    new_map->image_size = 0;
+
+    map_parser parser = {new_map, {0, 0, NULL, NULL}, MAP_SECTION_NAME, 0, 0, 1, 0, error};
+    new_map->ascii_map = (char *)malloc(parser.ascii_map_capacity);
+    new_map->ascii_map[0] = '\0';
+
+    // Read the file one line at a time, lines may be any length
+    char *line = NULL;
+    size_t line_capacity = 0;
+    ssize_t line_length;
+    bool ok = true;
+    while (ok && (line_length = getline(&line, &line_capacity, fp)) != -1) {
+        parser.line_number++;
+        ok = _parse_map_line(&parser, line, line_length);
+    }
+
+    free(line);
     fclose(fp);
 
+    if (ok && parser.section == MAP_SECTION_NAME) {
+        ok = map_error_at(error, 1, 1, "Missing map name");
+    } else if (ok && (new_map->player_start_room == NULL || new_map->xenomorph_start_room == NULL ||
+                      new_map->ash_start_room == NULL)) {
+        ok = map_error_at(error, 0, 0, "Player, Xenomorph, and Ash start rooms must all be defined");
+    }
+
+    if (!ok) {
+        free(parser.connections.from);
+        free(parser.connections.to);
+        free_map(new_map);
+        return NULL;
+    }
+
+    // Look up the rooms the rules refer to by name
+    new_map->docking_bay = get_room(new_map, "DOCKING BAY");
+    new_map->airlock = get_room(new_map, "AIRLOCK");
+    new_map->bridge = get_room(new_map, "BRIDGE");
+    new_map->equipment_storage = get_room(new_map, "EQUIPMENT STORAGE");
+    new_map->mu_th_ur = get_room(new_map, "MU-TH-UR");
+
+    build_adjacency(new_map, &parser.connections);
+    free(parser.connections.from);
+    free(parser.connections.to);
+
+    build_path_tables(new_map);
+    build_distance_rings(new_map);
+
     return new_map;
 }
 
 /**
  * Print out a text representation of the map
+ * @param out       Stream to print to, NULL to print nothing
  * @param game_map  The map to print out
  */
-void print_map(const map *game_map)
+void print_map(FILE *out, const map *game_map)
 {
-    printf("---NAME---\n%s\n\n", game_map->name);
+    if (out == NULL) {
+        return;
+    }
+
+    fprintf(out, "---NAME---\n%s\n\n", game_map->name);
 
-    printf("---ROOMS---\n");
+    fprintf(out, "---ROOMS---\n");
     for (int i = 0; i < game_map->room_count; i++) {
         if (game_map->rooms[i]->is_corridor) {
             continue;
         }
 
-        print_room(game_map->rooms[i], 1);
+        print_room(out, game_map, game_map->rooms[i], NULL, NULL, 1);
 
         if (game_map->player_start_room == game_map->rooms[i]) {
-            printf("\t<Player Start Room>\n");
+            fprintf(out, "\t<Player Start Room>\n");
         } else if (game_map->xenomorph_start_room == game_map->rooms[i]) {
-            printf("\t<Xenomorph Start Room>\n");
+            fprintf(out, "\t<Xenomorph Start Room>\n");
         } else if (game_map->ash_start_room == game_map->rooms[i]) {
-            printf("\t<Ash Start Room>\n");
+            fprintf(out, "\t<Ash Start Room>\n");
         }
 
-        printf("\n");
+        fprintf(out, "\n");
     }
-    printf("\n");
+    fprintf(out, "\n");
 
     /*
     printf("---CORRIDORS---\n");
@@ -371,3 +1257,34 @@ void print_map(const map *game_map)
     printf("\n");
     */
 }
+
+/**
+ * Free a map, its rooms, and everything read_map built for it
+ * @param game_map  The map to free
+ */
+void free_map(map *game_map)
+{
+    if (game_map->image != NULL) {
+        free_compiled_map(game_map);
+        return;
+    }
+
+    for (int i = 0; i < game_map->room_count; i++) {
+        free(game_map->rooms[i]);
+    }
+
+    free(game_map->rooms);
+    free(game_map->named_room_indices);
+    free(game_map->scrap_rooms);
+    free(game_map->event_rooms);
+    free(game_map->coolant_rooms);
+    free(game_map->ascii_map);
+    free(game_map->room_index);
+    free(game_map->adjacency_offsets);
+    free(game_map->adjacency);
+    free(game_map->rooms_at_distance);
+    free(game_map->rooms_within_distance);
+    free(game_map->distances);
+    free(game_map->next_hop);
+    free(game_map);
+}
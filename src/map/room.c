@@ -6,105 +6,75 @@
 */
 
 #include "map/room.h"
+#include "map/map.h"
 
-room *create_room(char name[32], bool is_corridor)
+room *create_room(char name[ROOM_NAME_LENGTH], bool is_corridor)
 {
     room *new_room = (room *)malloc(sizeof(room));
 
     strcpy(new_room->name, name);
+    new_room->id = -1;
     new_room->is_corridor = is_corridor;
 
-    new_room->num_scrap = 0;
-    new_room->has_event = false;
-
-    new_room->num_items = 0;
-    for (int i = 0; i < NUM_ROOM_ITEMS; i++) {
-        new_room->room_items[i] = NULL;
-    }
-
-    new_room->connection_count = 0;
-    for (int i = 0; i < 8; i++) {
-        new_room->connections[i] = NULL;
-    }
     new_room->ladder_connection = NULL;
 
-    new_room->search_distance = -1;
-    new_room->search_discovered = false;
-    new_room->search_previous_room = NULL;
-
-    new_room->room_queue_next = NULL;
-
     return new_room;
 }
 
-void add_connection(room *a, room *b)
+/**
+ * Print a room and its connections
+ * @param out          Stream to print to, NULL to print nothing
+ * @param game_map     Map the room belongs to
+ * @param r            Room to print
+ * @param state        The room's Scrap, items, and event in a game, NULL to print it as it is before a game
+ * @param items        Item pool of the game `state` is from, see game_manager
+ * @param prepend_tab  Whether or not to indent every line with a tab
+ */
+void print_room(FILE *out, const map *game_map, room *r, const room_state *state, const item *items, bool prepend_tab)
 {
-    if (a->connection_count >= 8) {
-        fprintf(stderr, "[ERROR] - Room %s has more than 8 connections\n", a->name);
-        exit(1);
-    } else if (b->connection_count >= 8) {
-        fprintf(stderr, "[ERROR] - Room %s has more than 8 connections\n", b->name);
-        exit(1);
+    if (out == NULL) {
+        return;
     }
 
-    bool found = false;
-    for (int i = 0; i < a->connection_count; i++) {
-        if (a->connections[i] == b) {
-            found = true;
-            break;
+    room_state empty_state = {0};
+    if (state == NULL) {
+        for (int i = 0; i < NUM_ROOM_ITEMS; i++) {
+            empty_state.room_items[i] = NO_ITEM;
         }
-    }
-    if (!found) {
-        a->connections[a->connection_count] = b;
-        a->connection_count++;
+        state = &empty_state;
     }
 
-    found = false;
-    for (int i = 0; i < b->connection_count; i++) {
-        if (b->connections[i] == a) {
-            found = true;
-            break;
-        }
-    }
-    if (!found) {
-        b->connections[b->connection_count] = a;
-        b->connection_count++;
-    }
-}
-
-void print_room(room *r, bool prepend_tab)
-{
     char *prepend = prepend_tab ? "\t" : "";
-    printf("%sName: %s\n", prepend, r->name);
-    printf("%sType: %s\n", prepend, r->is_corridor ? "Corridor" : "Room");
-    printf("%sScrap: %d\n", prepend, r->num_scrap);
+    fprintf(out, "%sName: %s\n", prepend, r->name);
+    fprintf(out, "%sType: %s\n", prepend, r->is_corridor ? "Corridor" : "Room");
+    fprintf(out, "%sScrap: %d\n", prepend, state->num_scrap);
 
-    printf("%sItems: ", prepend);
+    fprintf(out, "%sItems: ", prepend);
     bool found_item = false;
     for (int i = 0; i < NUM_ROOM_ITEMS; i++) {
-        if (r->room_items[i] != NULL) {
+        if (state->room_items[i] != NO_ITEM) {
             if (!found_item) {
                 found_item = true;
-                printf("\n");
+                fprintf(out, "\n");
             }
 
-            printf("%s\t", prepend);
-            print_item(r->room_items[i]);
+            fprintf(out, "%s\t", prepend);
+            print_item(out, &items[state->room_items[i]]);
         }
     }
     if (!found_item) {
-        printf("None\n");
+        fprintf(out, "None\n");
     }
 
-    printf("%sHas Event: %s\n", prepend, r->has_event ? "True" : "False");
+    fprintf(out, "%sHas Event: %s\n", prepend, state->has_event ? "True" : "False");
 
-    printf("%sConnections: ", prepend);
-    for (int i = 0; i < r->connection_count; i++) {
-        printf("%s ", r->connections[i]->name);
+    fprintf(out, "%sConnections: ", prepend);
+    for (int i = 0; i < room_connection_count(game_map, r); i++) {
+        fprintf(out, "%s ", room_connection(game_map, r, i)->name);
     }
-    printf("\n");
+    fprintf(out, "\n");
 
     if (r->ladder_connection != NULL) {
-        printf("%sLadder Connection: %s\n", prepend, r->ladder_connection->name);
+        fprintf(out, "%sLadder Connection: %s\n", prepend, r->ladder_connection->name);
     }
 }
@@ -0,0 +1,627 @@
+/**
+ * @file
+ * @date   16-Oct-2026
+ * @brief Logic for the Monte Carlo Tree Search crew AI
+*/
+
+#include <math.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "mcts.h"
+
+// Exploration constant of the UCT formula, for rollout values between 0 and 1
+#define MCTS_EXPLORATION 0.7
+
+// A key sequence the search has tried, reached from its parent by `key`. Because every rollout reseeds
+// the game's random events, a node stands for every game that follows its keys, not one game
+typedef struct mcts_node {
+    char key;
+    // Children are stored next to each other, starting at first_child
+    int first_child;
+    int num_children;
+    // Whether the decision after this node's keys has been seen, a node with no children after that is
+    // the end of the game
+    bool expanded;
+
+    int visits;
+    double total_value;
+} mcts_node;
+
+// Plays rollouts: answers with the keys of the searched line, then at random. Records the answers to the
+// first decision after the line so the tree can grow there
+typedef struct rollout_input {
+    input_provider provider;
+
+    const char *script;
+    int script_length;
+    int position;
+    // Set once a scripted key isn't valid, when the reseeded game went somewhere the line never has
+    bool diverged;
+
+    // Whether to record the first decision after the script
+    bool expand;
+    // The recorded answers and the index of the one played, num_candidates is -1 until recorded
+    char candidates[MAX_BOT_CHOICES];
+    int num_candidates;
+    int chosen;
+
+    random_state rng;
+} rollout_input;
+
+// What every thread of one search shares, read-only while the search runs
+typedef struct mcts_search {
+    const game_state *root;
+    const char *prefix;
+    int prefix_length;
+    // Answers to the decision being searched
+    const char *candidates;
+    int num_candidates;
+    int horizon;
+
+    // Time the search stops at, if timed
+    bool timed;
+    struct timespec deadline;
+} mcts_search;
+
+// One search thread, with its own tree and its own game to play rollouts in
+typedef struct mcts_worker {
+    const mcts_search *search;
+    // Rollouts this thread plays in the current search, 0 for no limit
+    long iterations;
+    long rollouts;
+
+    mcts_node *nodes;
+    int num_nodes;
+    int node_capacity;
+
+    game_manager *game;
+    rollout_input input;
+    random_state rng;
+} mcts_worker;
+
+/**
+ * Answer a rollout's decision, see rollout_input
+ */
+char _rollout_choose(input_provider *self, struct game_manager *manager, DECISION_TYPES decision, const char *options)
+{
+    rollout_input *input = (rollout_input *)self;
+
+    if (!input->diverged && input->position < input->script_length) {
+        char key = input->script[input->position++];
+        if (strchr(options, key) != NULL) {
+            return key;
+        }
+        input->diverged = true;
+    }
+
+    char candidates[MAX_BOT_CHOICES];
+    int num_candidates = get_bot_choices(decision, options, candidates);
+    if (num_candidates == 0) {
+        candidates[0] = options[0];
+        num_candidates = 1;
+    }
+
+    int pick = random_below(&input->rng, num_candidates);
+
+    if (input->expand && !input->diverged && input->num_candidates < 0) {
+        memcpy(input->candidates, candidates, num_candidates);
+        input->num_candidates = num_candidates;
+        input->chosen = pick;
+    }
+
+    return candidates[pick];
+}
+
+/**
+ * Share of the way to winning the final mission, from the conditions update_final_mission and
+ * trigger_encounter check for it
+ * @param  game                   Game to score
+ * @return          Progress between 0 and 1, 0 if the final mission hasn't started
+ */
+double _final_mission_progress(const game_manager *game)
+{
+    if (!game->is_final_mission) {
+        return 0.0;
+    }
+
+    const map *game_map = game->game_map;
+    int steps = 0;
+    int total = 0;
+
+    switch (game->final_mission_type) {
+    case YOU_HAVE_MY_SYMPATHIES:
+        // Won by using a coolant canister on Ash until he is killed, then driving the Xenomorph back
+        if (game->ash_killed) {
+            return 1.0;
+        }
+        steps = 2 * (3 - game->ash_health);
+        total = 7;
+        for (int i = 0; i < game->character_count; i++) {
+            if (game->characters[i]->coolant != NO_ITEM) {
+                steps++;
+                break;
+            }
+        }
+        break;
+    case ESCAPE_ON_THE_NARCISSUS:;
+        // Won with everyone in the docking bay, a canister each dropped there, and the cat carrier and
+        // incinerator held
+        room *docking_bay = game_map->docking_bay != NULL ? game_map->docking_bay : game_map->player_start_room;
+        const room_state *docking_bay_state = &game->room_states[docking_bay->id];
+
+        int num_canisters = 0;
+        for (int i = 0; i < NUM_ROOM_ITEMS; i++) {
+            const item *dropped = get_item(game, docking_bay_state->room_items[i]);
+            num_canisters += dropped != NULL && dropped->type == COOLANT_CANISTER;
+        }
+
+        bool has_carrier = false;
+        bool has_incinerator = false;
+        for (int i = 0; i < game->character_count; i++) {
+            steps += game->characters[i]->current_room == docking_bay;
+            has_carrier |= character_has_item(game, game->characters[i], CAT_CARRIER);
+            has_incinerator |= character_has_item(game, game->characters[i], INCINERATOR);
+        }
+        steps += min(num_canisters, game->character_count) + has_carrier + has_incinerator;
+        total = 2 * game->character_count + 2;
+        break;
+    case BLOW_IT_OUT_INTO_SPACE:;
+        // Won by drawing an alien card with the Xenomorph at or next to the docking bay, and the crew at the
+        // airlock and bridge
+        room *bay = game_map->docking_bay != NULL ? game_map->docking_bay : game_map->player_start_room;
+        room *airlock = game_map->airlock != NULL ? game_map->airlock : game_map->ash_start_room;
+        room *bridge = game_map->bridge != NULL ? game_map->bridge : game_map->xenomorph_start_room;
+
+        bool xeno_in_right_place = game->xenomorph_location == bay;
+        for (int i = 0; i < room_connection_count(game_map, bay); i++) {
+            xeno_in_right_place |= game->xenomorph_location == room_connection(game_map, bay, i);
+        }
+
+        bool airlock_right_place = false;
+        bool bridge_right_place = false;
+        for (int i = 0; i < game->character_count; i++) {
+            if (game->characters[i]->current_room == airlock) {
+                airlock_right_place = true;
+            } else if (game->characters[i]->current_room == bridge) {
+                bridge_right_place = true;
+            }
+        }
+        steps = xeno_in_right_place + airlock_right_place + bridge_right_place;
+        total = 3;
+        if (steps == total) {
+            // All that's left is the chance that the next card is an alien
+            const encounter_odds *odds = get_encounter_odds(&game->encounters, 1);
+            return (total + odds->chance[1][0]) / (total + 1);
+        }
+        break;
+    case WERE_GOING_TO_BLOW_UP_THE_SHIP:;
+        // Won with everyone in the airlock holding a coolant canister and scrap
+        room *blast_airlock = game_map->airlock != NULL ? game_map->airlock : game_map->player_start_room;
+        for (int i = 0; i < game->character_count; i++) {
+            const character *c = game->characters[i];
+            steps += (c->coolant != NO_ITEM) + (c->num_scrap > 0) + (c->current_room == blast_airlock);
+        }
+        total = 3 * game->character_count;
+        break;
+    case CUT_OFF_EVERY_BULKHEAD_AND_VENT:
+        // Won once no named room has an event left
+        for (int i = 0; i < game_map->named_room_count; i++) {
+            steps += !game->room_states[game_map->named_room_indices[i]].has_event;
+        }
+        total = game_map->named_room_count;
+        break;
+    }
+
+    return total > 0 ? (double)steps / total : 0.0;
+}
+
+/**
+ * Score a finished rollout between 0 and 1. Wins score 1 and losses 0. Rollouts stopped at the horizon
+ * score in between, by how much morale is left and how close the crew is to winning
+ * @param  game                   Game the rollout was played in
+ * @param  outcome                How the rollout ended
+ * @param  root                   State the rollout started from
+ * @return          Value of the rollout
+ */
+double _evaluate_rollout(const game_manager *game, game_outcome outcome, const game_state *root)
+{
+    if (outcome.result == GAME_WON) {
+        return 1.0;
+    } else if (outcome.result != GAME_ROUND_LIMIT) {
+        return 0.0;
+    }
+
+    double morale = root->morale > 0 ? (double)min(game->morale, root->morale) / root->morale : 0.0;
+
+    int completed = 0;
+    for (int i = 0; i < game->num_objectives; i++) {
+        completed += game->game_objectives[i].completed;
+    }
+    double objectives = game->num_objectives > 0 ? (double)completed / game->num_objectives : 0.0;
+
+    double final_mission = game->is_final_mission ? 0.5 + 0.5 * _final_mission_progress(game) : 0.0;
+
+    return 0.05 + 0.4 * morale + 0.25 * objectives + 0.25 * final_mission;
+}
+
+/**
+ * Get the child of a node to search next: the first unvisited one, otherwise the one with the best UCT score
+ */
+int _select_child(const mcts_worker *worker, int parent)
+{
+    const mcts_node *node = &worker->nodes[parent];
+    double log_visits = log((double)node->visits);
+
+    int best = node->first_child;
+    double best_score = -1.0;
+    for (int i = node->first_child; i < node->first_child + node->num_children; i++) {
+        const mcts_node *child = &worker->nodes[i];
+        if (child->visits == 0) {
+            return i;
+        }
+
+        double score = child->total_value / child->visits + MCTS_EXPLORATION * sqrt(log_visits / child->visits);
+        if (score > best_score) {
+            best_score = score;
+            best = i;
+        }
+    }
+
+    return best;
+}
+
+/**
+ * Add children with the given keys to a node of a worker's tree
+ */
+void _expand_node(mcts_worker *worker, int parent, const char *keys, int num_keys)
+{
+    if (worker->num_nodes + num_keys > worker->node_capacity) {
+        while (worker->num_nodes + num_keys > worker->node_capacity) {
+            worker->node_capacity *= 2;
+        }
+        worker->nodes = (mcts_node *)realloc(worker->nodes, sizeof(mcts_node) * worker->node_capacity);
+    }
+
+    worker->nodes[parent].first_child = worker->num_nodes;
+    worker->nodes[parent].num_children = num_keys;
+    worker->nodes[parent].expanded = true;
+
+    for (int i = 0; i < num_keys; i++) {
+        mcts_node *child = &worker->nodes[worker->num_nodes++];
+        child->key = keys[i];
+        child->first_child = 0;
+        child->num_children = 0;
+        child->expanded = false;
+        child->visits = 0;
+        child->total_value = 0.0;
+    }
+}
+
+/**
+ * Play one search iteration: pick a line down the tree, play a rollout along it from the root state with
+ * new random events, grow the tree by one decision, and add the rollout's value to the line
+ * @param worker  Worker to search with
+ */
+void _run_iteration(mcts_worker *worker)
+{
+    const mcts_search *search = worker->search;
+
+    int path[MCTS_MAX_DEPTH + 1];
+    int depth = 0;
+    char script[MCTS_MAX_DEPTH];
+    int script_length = search->prefix_length;
+    memcpy(script, search->prefix, script_length);
+
+    // Selection
+    int node = 0;
+    path[depth++] = node;
+    while (worker->nodes[node].num_children > 0 && script_length < MCTS_MAX_DEPTH) {
+        node = _select_child(worker, node);
+        path[depth++] = node;
+        script[script_length++] = worker->nodes[node].key;
+    }
+
+    // Rollout. The AI can't know the upcoming dice or encounter cards, so each rollout draws new ones
+    game_manager *game = worker->game;
+    restore_game_state(game, search->root);
+    seed_random(&game->rng, ((uint64_t)random_next(&worker->rng) << 32) | random_next(&worker->rng), 0);
+    shuffle_encounters(&game->encounters, &game->rng);
+    game->max_rounds = search->root->round_index + search->horizon - 1;
+
+    rollout_input *input = &worker->input;
+    input->script = script;
+    input->script_length = script_length;
+    input->position = 0;
+    input->diverged = false;
+    input->expand = !worker->nodes[node].expanded && script_length < MCTS_MAX_DEPTH;
+    input->num_candidates = -1;
+
+    game_outcome outcome = game_loop(game);
+    double value = _evaluate_rollout(game, outcome, search->root);
+    worker->rollouts++;
+
+    // Expansion
+    if (input->num_candidates >= 0) {
+        _expand_node(worker, node, input->candidates, input->num_candidates);
+        path[depth++] = worker->nodes[node].first_child + input->chosen;
+    } else if (input->expand && !input->diverged && input->position == script_length) {
+        // The game ended before another decision came up
+        worker->nodes[node].expanded = true;
+    }
+
+    // Backpropagation, every decision is made for the crew so every node maximizes the same value
+    for (int i = 0; i < depth; i++) {
+        worker->nodes[path[i]].visits++;
+        worker->nodes[path[i]].total_value += value;
+    }
+}
+
+/**
+ * Check if a search has run out of time
+ */
+bool _search_timed_out(const mcts_search *search)
+{
+    if (!search->timed) {
+        return false;
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec > search->deadline.tv_sec ||
+           (now.tv_sec == search->deadline.tv_sec && now.tv_nsec >= search->deadline.tv_nsec);
+}
+
+/**
+ * Thread function of a search worker. Builds a tree for the worker's share of the search
+ * @param  arg                    The mcts_worker running on this thread
+ * @return          NULL
+ */
+void *_mcts_worker(void *arg)
+{
+    mcts_worker *worker = (mcts_worker *)arg;
+    const mcts_search *search = worker->search;
+
+    // The root is the decision being searched, so its children are already known
+    worker->num_nodes = 1;
+    worker->nodes[0].visits = 0;
+    worker->nodes[0].total_value = 0.0;
+    _expand_node(worker, 0, search->candidates, search->num_candidates);
+
+    worker->rollouts = 0;
+    while ((worker->iterations == 0 || worker->rollouts < worker->iterations) && !_search_timed_out(search)) {
+        _run_iteration(worker);
+    }
+
+    return NULL;
+}
+
+/**
+ * Release the search threads' trees and games
+ */
+void _free_mcts_workers(mcts_input *ai)
+{
+    for (int i = 0; i < ai->settings.threads; i++) {
+        free(ai->workers[i].nodes);
+        free_game(ai->workers[i].game);
+    }
+    free(ai->workers);
+    ai->workers = NULL;
+}
+
+/**
+ * Create the search threads' trees, games, and generators
+ * @return  False, with no search threads created, if there isn't enough memory for their games
+ */
+bool _create_mcts_workers(mcts_input *ai, map *game_map)
+{
+    ai->workers = (struct mcts_worker *)calloc(ai->settings.threads, sizeof(mcts_worker));
+    for (int i = 0; i < ai->settings.threads; i++) {
+        mcts_worker *worker = &ai->workers[i];
+
+        worker->node_capacity = 1024;
+        worker->nodes = (mcts_node *)malloc(sizeof(mcts_node) * worker->node_capacity);
+
+        worker->input.provider.choose = _rollout_choose;
+        worker->input.provider.free = NULL;
+        // Streams 0 and 1 of the seed are the game's and the players', see main.c
+        seed_random(&worker->input.rng, ai->settings.seed, 2 * (uint64_t)i + 2);
+        seed_random(&worker->rng, ai->settings.seed, 2 * (uint64_t)i + 3);
+
+        worker->game = new_game_from_state(ai->root, game_map, &worker->input.provider, NULL);
+        if (worker->game == NULL) {
+            _free_mcts_workers(ai);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Search the decision after the root state and the prefix, across every thread. Each thread builds its
+ * own tree, then their visit counts at the root are added up
+ * @param  ai                     The crew AI, with its search threads created
+ * @param  candidates             Answers to the decision
+ * @param  num_candidates         Number of answers
+ * @return          Index of the most visited answer
+ */
+int _search(mcts_input *ai, const char *candidates, int num_candidates)
+{
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    mcts_search search;
+    search.root = ai->root;
+    search.prefix = ai->prefix;
+    search.prefix_length = ai->prefix_length;
+    search.candidates = candidates;
+    search.num_candidates = num_candidates;
+    search.horizon = ai->settings.horizon;
+    search.timed = ai->settings.time_limit > 0;
+    search.deadline.tv_sec = start.tv_sec + ai->settings.time_limit / 1000;
+    search.deadline.tv_nsec = start.tv_nsec + (ai->settings.time_limit % 1000) * 1000000L;
+    if (search.deadline.tv_nsec >= 1000000000L) {
+        search.deadline.tv_sec++;
+        search.deadline.tv_nsec -= 1000000000L;
+    }
+
+    // Split the iterations evenly, so untimed searches pick the same answers on every run
+    int threads = ai->settings.threads;
+    pthread_t *thread_ids = (pthread_t *)malloc(sizeof(pthread_t) * threads);
+    for (int i = 0; i < threads; i++) {
+        mcts_worker *worker = &ai->workers[i];
+        worker->search = &search;
+        worker->iterations = ai->settings.iterations / threads + (i < ai->settings.iterations % threads);
+        if (ai->settings.iterations > 0 && worker->iterations == 0) {
+            worker->iterations = 1;
+        }
+
+        if (threads > 1) {
+            pthread_create(&thread_ids[i], NULL, _mcts_worker, worker);
+        } else {
+            _mcts_worker(worker);
+        }
+    }
+
+    long visits[MAX_BOT_CHOICES] = {0};
+    double values[MAX_BOT_CHOICES] = {0};
+    for (int i = 0; i < threads; i++) {
+        mcts_worker *worker = &ai->workers[i];
+        if (threads > 1) {
+            pthread_join(thread_ids[i], NULL);
+        }
+
+        const mcts_node *root = &worker->nodes[0];
+        for (int j = 0; j < num_candidates; j++) {
+            visits[j] += worker->nodes[root->first_child + j].visits;
+            values[j] += worker->nodes[root->first_child + j].total_value;
+        }
+        ai->rollouts += worker->rollouts;
+    }
+    free(thread_ids);
+
+    int best = 0;
+    for (int i = 1; i < num_candidates; i++) {
+        if (visits[i] > visits[best] || (visits[i] == visits[best] && values[i] > values[best])) {
+            best = i;
+        }
+    }
+
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    ai->search_seconds += (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    ai->decisions++;
+
+    return best;
+}
+
+/**
+ * Answer a decision in one of the AI's turns by searching it, and pass other decisions to the fallback
+ */
+char _mcts_choose(input_provider *self, struct game_manager *manager, DECISION_TYPES decision, const char *options)
+{
+    mcts_input *ai = (mcts_input *)self;
+
+    if (manager == NULL || ai->out_of_memory || !manager->turn_in_progress || manager->turn_index < ai->first_turn) {
+        return ai->fallback->choose(ai->fallback, manager, decision, options);
+    }
+
+    // Every action menu can be resumed from, so searches start there
+    if (decision == DECISION_ACTION) {
+        if (ai->root == NULL) {
+            ai->root = new_game_state(manager->game_map);
+        }
+        capture_game_state(manager, ai->root);
+        ai->root_round = manager->round_index;
+        ai->root_turn = manager->turn_index;
+        ai->prefix_length = 0;
+    }
+
+    char candidates[MAX_BOT_CHOICES];
+    int num_candidates = get_bot_choices(decision, options, candidates);
+    if (num_candidates == 0) {
+        return options[0];
+    }
+
+    bool searchable = ai->root != NULL && ai->root_round == manager->round_index &&
+                      ai->root_turn == manager->turn_index && ai->prefix_length < MCTS_MAX_DEPTH;
+
+    char choice = candidates[0];
+    if (searchable && num_candidates > 1) {
+        if (ai->workers == NULL && !_create_mcts_workers(ai, manager->game_map)) {
+            fprintf(stderr, "[WARNING] - Not enough memory for the crew AI's searches, its fallback decides instead\n");
+            ai->out_of_memory = true;
+            return ai->fallback->choose(ai->fallback, manager, decision, options);
+        }
+        choice = candidates[_search(ai, candidates, num_candidates)];
+    }
+
+    if (searchable) {
+        ai->prefix[ai->prefix_length++] = choice;
+    }
+
+    return choice;
+}
+
+/**
+ * Release the crew AI, its search threads' games, and its fallback
+ */
+void _free_mcts_input(input_provider *self)
+{
+    mcts_input *ai = (mcts_input *)self;
+
+    if (ai->workers != NULL) {
+        _free_mcts_workers(ai);
+    }
+
+    free(ai->root);
+    ai->fallback->free(ai->fallback);
+    free(ai);
+}
+
+/**
+ * Create the crew AI, which searches every decision of the characters it plays with Monte Carlo Tree
+ * Search. Rollouts play the rest of the searched line at random until `settings.horizon` round ends
+ * @param  settings               Search budget and threads
+ * @param  first_turn             Index of the first turn of each round the AI plays, it plays the rest
+ * @param  fallback               Provider for every other decision, the AI takes ownership of it
+ * @return          Pointer to the new provider
+ */
+input_provider *new_mcts_input(mcts_settings settings, int first_turn, input_provider *fallback)
+{
+    mcts_input *ai = (mcts_input *)calloc(1, sizeof(mcts_input));
+    ai->provider.choose = _mcts_choose;
+    ai->provider.free = _free_mcts_input;
+
+    ai->settings = settings;
+    if (ai->settings.threads < 1) {
+        ai->settings.threads = 1;
+    }
+    if (ai->settings.horizon < 1) {
+        ai->settings.horizon = 1;
+    }
+    if (ai->settings.iterations <= 0 && ai->settings.time_limit <= 0) {
+        ai->settings.iterations = MCTS_DEFAULT_ITERATIONS;
+    }
+    ai->first_turn = first_turn;
+    ai->fallback = fallback;
+
+    return (input_provider *)ai;
+}
+
+/**
+ * Print how much the crew AI searched
+ * @param out  Stream to print to
+ * @param ai   The crew AI
+ */
+void print_mcts_statistics(FILE *out, const mcts_input *ai)
+{
+    fprintf(out,
+            "AI searched %ld decisions with %ld rollouts in %.2f seconds (%.0f rollouts/s)\n",
+            ai->decisions,
+            ai->rollouts,
+            ai->search_seconds,
+            ai->search_seconds > 0 ? ai->rollouts / ai->search_seconds : 0.0);
+}
@@ -7,7 +7,7 @@
 
 #include "objective.h"
 
-objective objectives_stack[NUM_OBJECTIVES] = {
+const objective objectives_stack[NUM_OBJECTIVES] = {
     {"PREP SUITS", DROP_COOLANT, false, "SUIT STORAGE", 0, 0, 0},
     {"WE'LL TAKE OUR CHANCES IN THE SHUTTLE", DROP_COOLANT, false, "DOCKING BAY", 0, 0, 0},
     {"CREW MEETING", CREW_AT_LOCATION_WITH_MINIMUM_SCRAP, false, "GALLEY", 0, 0, 1},
@@ -37,66 +37,77 @@ char *final_mission_desc[NUM_FINAL_MISSIONS] = {
     "Clear all Events within 4 turns before the Nostromo self-destructs."};
 
 /**
- * Get an array of n random objectives
- * @param  n               Number of objectives to get
- * @return   An array of objectives allocated on the heap
+ * Pick n random objectives
+ * @param out  Filled with the objectives, room for at least n
+ * @param n    Number of objectives to get
+ * @param rng  Generator to pick objectives with
  */
-objective *get_objectives(int n)
+void get_objectives(objective *out, int n, random_state *rng)
 {
     if (n < 1 || n > NUM_OBJECTIVES) {
         printf("[ERROR] - Number of objectives must be in [1, %d]\n", NUM_OBJECTIVES);
         exit(1);
     }
 
-    objective *out = (objective *)malloc(sizeof(objective) * n);
-
-    // Shuffle objectives
+    // Shuffle a copy of the objectives, so every game draws from the same order
+    objective shuffled[NUM_OBJECTIVES];
+    memcpy(shuffled, objectives_stack, sizeof(shuffled));
     for (int i = NUM_OBJECTIVES - 1; i > 0; i--) {
-        int j = rand() % (i + 1);
+        int j = randint(rng, 0, i);
 
-        objective tmp = objectives_stack[i];
-        objectives_stack[i] = objectives_stack[j];
-        objectives_stack[j] = tmp;
+        objective tmp = shuffled[i];
+        shuffled[i] = shuffled[j];
+        shuffled[j] = tmp;
     }
 
     for (int i = 0; i < n; i++) {
-        out[i] = objectives_stack[i];
+        out[i] = shuffled[i];
     }
-
-    return out;
 }
 
-void complete_objective(objective *o)
+/**
+ * Mark an objective as completed
+ * @param out  Stream to announce the completion on, NULL to print nothing
+ * @param o    Objective to complete
+ */
+void complete_objective(FILE *out, objective *o)
 {
-    printf("[OBJECTIVE] - Completed objective %s!\n", o->name);
+    if (out != NULL) {
+        fprintf(out, "[OBJECTIVE] - Completed objective %s!\n", o->name);
+    }
     o->completed = true;
 }
 
 /**
  * Print a description of an objective
- * @param o  Objective to print
+ * @param out  Stream to print to, NULL to print nothing
+ * @param o    Objective to print
  */
-void print_objective_description(objective o)
+void print_objective_description(FILE *out, objective o)
 {
-    printf("%s: ", o.name);
+    if (out == NULL) {
+        return;
+    }
+
+    fprintf(out, "%s: ", o.name);
     if (o.completed) {
-        printf("[COMPLETED] - ");
+        fprintf(out, "[COMPLETED] - ");
     }
 
     switch (o.type) {
     case BRING_ITEM_TO_LOCATION:
-        printf("Bring %s to %s\n", item_names[o.target_item_type], o.location->name);
+        fprintf(out, "Bring %s to %s\n", item_names[o.target_item_type], o.location->name);
         break;
     case CREW_AT_LOCATION_WITH_MINIMUM_SCRAP:
-        printf("All Crew members in %s", o.location->name);
+        fprintf(out, "All Crew members in %s", o.location->name);
         if (o.minimum_scrap > 0) {
-            printf(" with at least %d scrap in each Crew member's inventory.\n", o.minimum_scrap);
+            fprintf(out, " with at least %d scrap in each Crew member's inventory.\n", o.minimum_scrap);
         } else {
-            printf("\n");
+            fprintf(out, "\n");
         }
         break;
     case DROP_COOLANT:
-        printf("Drop 2 COOLANT CANISTERS in %s\n", o.location->name);
+        fprintf(out, "Drop 2 COOLANT CANISTERS in %s\n", o.location->name);
         break;
     }
 }
@@ -0,0 +1,350 @@
+/**
+ * @file
+ * @date   16-Oct-2026
+ * @brief Recording games to replay logs, and replaying them headlessly
+*/
+
+#include <errno.h>
+#include <limits.h>
+
+#include "game_state.h"
+#include "replay.h"
+
+// Answers decisions with the keys of a replay log, ending the game once they run out
+typedef struct replay_input {
+    input_provider provider;
+
+    const char *keys;
+    long num_keys;
+    long position;
+    // Set if the game asked for more decisions than the log has
+    bool ran_out;
+} replay_input;
+
+/**
+ * Ask the recorded provider for a decision and log its answer
+ */
+char _recording_choose(input_provider *self, struct game_manager *manager, DECISION_TYPES decision, const char *options)
+{
+    recording_input *recorder = (recording_input *)self;
+
+    // Every key is logged, even ones the game asks again for, so replays see exactly the same input
+    char ch = recorder->inner->choose(recorder->inner, manager, decision, options);
+    fputc(ch, recorder->log);
+    recorder->decisions++;
+
+    return ch;
+}
+
+/**
+ * Close a recording's log, and release the recorded provider
+ */
+void _free_recording_input(input_provider *self)
+{
+    recording_input *recorder = (recording_input *)self;
+
+    fclose(recorder->log);
+    recorder->inner->free(recorder->inner);
+    free(recorder);
+}
+
+/**
+ * Create a provider that records a game to a replay log. The log's header is written right away, and every
+ * decision as it is made, so games that are killed can still be replayed up to where they stopped
+ * @param  fn                     Filename of the log to write
+ * @param  args                   Arguments the game is created with
+ * @param  game_map               Map the game is played on, read from args->game_file
+ * @param  inner                  Provider to record, the recorder takes ownership of it
+ * @param  error                  Filled in with the reason if the log can't be created
+ * @return          Pointer to the new provider, NULL if the log can't be created
+ */
+input_provider *new_recording_input(const char *fn,
+                                    const arguments *args,
+                                    const map *game_map,
+                                    input_provider *inner,
+                                    map_error *error)
+{
+    replay_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+    header.version = REPLAY_VERSION;
+    header.byte_order = REPLAY_BYTE_ORDER;
+    header.seed = args->seed;
+    header.n_players = args->n_players;
+    header.n_characters = args->n_characters;
+    header.use_ash = args->use_ash;
+    header.room_count = game_map->room_count;
+    memcpy(header.map_name, game_map->name, sizeof(header.map_name));
+
+    // Logs are replayed from wherever the bug report ends up, so store where the map is, not how it was named
+    char resolved[PATH_MAX];
+    const char *game_file = realpath(args->game_file, resolved) != NULL ? resolved : args->game_file;
+    if (snprintf(header.game_file, sizeof(header.game_file), "%s", game_file) >= (int)sizeof(header.game_file)) {
+        map_error_at(error,
+                     0,
+                     0,
+                     "The map's full path is longer than the %zu bytes a replay log can store",
+                     sizeof(header.game_file) - 1);
+        return NULL;
+    }
+
+    FILE *fp = fopen(fn, "wb");
+    if (fp == NULL) {
+        map_error_at(error, 0, 0, "%s", strerror(errno));
+        return NULL;
+    }
+
+    fwrite(&header, sizeof(header), 1, fp);
+
+    recording_input *recorder = (recording_input *)malloc(sizeof(recording_input));
+    recorder->provider.choose = _recording_choose;
+    recorder->provider.free = _free_recording_input;
+    recorder->inner = inner;
+    recorder->log = fp;
+    recorder->decisions = 0;
+
+    return (input_provider *)recorder;
+}
+
+/**
+ * Write how a recorded game ended to the end of its log, so replays of it can be checked
+ * @param recorder  Provider made by new_recording_input
+ * @param manager   Game manager of the recorded game, after game_loop returned
+ * @param outcome   Outcome returned by game_loop
+ */
+void finish_recording(input_provider *recorder, const game_manager *manager, game_outcome outcome)
+{
+    recording_input *recording = (recording_input *)recorder;
+
+    game_state *state = new_game_state(manager->game_map);
+    capture_game_state(manager, state);
+
+    replay_trailer trailer;
+    memset(&trailer, 0, sizeof(trailer));
+    memcpy(trailer.magic, REPLAY_END_MAGIC, sizeof(REPLAY_END_MAGIC));
+    trailer.result = outcome.result;
+    trailer.round = outcome.round;
+    trailer.turn = outcome.turn;
+    trailer.decisions = recording->decisions;
+    trailer.state_hash = hash_game_state(state);
+    free(state);
+
+    fwrite(&trailer, sizeof(trailer), 1, recording->log);
+    fflush(recording->log);
+}
+
+/**
+ * Answer with the next key of the log, ending the game once the log runs out
+ */
+char _replay_choose(input_provider *self, struct game_manager *manager, DECISION_TYPES decision, const char *options)
+{
+    replay_input *replay = (replay_input *)self;
+
+    if (replay->position < replay->num_keys) {
+        return replay->keys[replay->position++];
+    }
+
+    replay->ran_out = true;
+    if (manager->end_of_game == NULL) {
+        // Only character selection asks for decisions outside of game_loop, and exiting it ends the game
+        return 'e';
+    }
+    end_game(manager, GAME_EXITED);
+
+    return '\0';
+}
+
+/**
+ * Read a whole file into memory
+ * @param  fn                     Filename of the file
+ * @param  size                   Set to the size of the file in bytes
+ * @return          Newly allocated contents of the file, NULL if it can't be read
+ */
+char *_read_file(const char *fn, long *size)
+{
+    FILE *fp = fopen(fn, "rb");
+    if (fp == NULL) {
+        return NULL;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    *size = ftell(fp);
+    rewind(fp);
+
+    char *contents = (char *)malloc(max(*size, 1));
+    if (fread(contents, 1, *size, fp) != (size_t)*size) {
+        free(contents);
+        contents = NULL;
+    }
+    fclose(fp);
+
+    return contents;
+}
+
+/**
+ * Replay a game from its log without printing anything, and check that it ends the way the log says
+ * @param  fn                     Filename of the log
+ * @param  summary                Filled in with what the replay found
+ * @param  error                  Filled in with the reason if the log or its map can't be read
+ * @return          True if the log was replayed, even if the replay didn't match
+ */
+bool replay_game(const char *fn, replay_summary *summary, map_error *error)
+{
+    long size;
+    char *log = _read_file(fn, &size);
+    if (log == NULL) {
+        return map_error_at(error, 0, 0, "Failed to read replay log: %s", strerror(errno));
+    }
+
+    replay_header header;
+    if (size < (long)sizeof(header)) {
+        free(log);
+        return map_error_at(error, 0, 0, "Not a replay log");
+    }
+    memcpy(&header, log, sizeof(header));
+    if (memcmp(header.magic, REPLAY_MAGIC, sizeof(REPLAY_MAGIC)) != 0) {
+        free(log);
+        return map_error_at(error, 0, 0, "Not a replay log");
+    } else if (header.version != REPLAY_VERSION) {
+        free(log);
+        return map_error_at(
+            error, 0, 0, "Replay log is version %u, this build reads version %d", header.version, REPLAY_VERSION);
+    } else if (header.byte_order != REPLAY_BYTE_ORDER) {
+        free(log);
+        return map_error_at(error, 0, 0, "Replay log was written on a machine with a different byte order");
+    }
+
+    memset(summary, 0, sizeof(replay_summary));
+
+    // Logs of finished games end with a trailer
+    long keys_end = size;
+    replay_trailer trailer;
+    if (size >= (long)(sizeof(header) + sizeof(trailer))) {
+        memcpy(&trailer, log + size - sizeof(trailer), sizeof(trailer));
+        if (memcmp(trailer.magic, REPLAY_END_MAGIC, sizeof(REPLAY_END_MAGIC)) == 0 &&
+            trailer.decisions == (uint64_t)(size - sizeof(header) - sizeof(trailer))) {
+            summary->complete = true;
+            summary->recorded.result = trailer.result;
+            summary->recorded.round = trailer.round;
+            summary->recorded.turn = trailer.turn;
+            keys_end -= sizeof(trailer);
+        }
+    }
+
+    header.game_file[sizeof(header.game_file) - 1] = '\0';
+    map *game_map = read_map(header.game_file, error);
+    if (game_map == NULL) {
+        free(log);
+        char reason[sizeof(error->message)];
+        strcpy(reason, error->message);
+        return map_error_at(error, 0, 0, "Failed to read the log's map %s: %s", header.game_file, reason);
+    } else if (game_map->room_count != header.room_count ||
+               strncmp(game_map->name, header.map_name, sizeof(header.map_name)) != 0) {
+        free_map(game_map);
+        free(log);
+        return map_error_at(error, 0, 0, "The map at %s changed since the log was recorded", header.game_file);
+    }
+
+    replay_input replay;
+    replay.provider.choose = _replay_choose;
+    replay.provider.free = NULL;
+    replay.keys = log + sizeof(header);
+    replay.num_keys = keys_end - sizeof(header);
+    replay.position = 0;
+    replay.ran_out = false;
+
+    arguments args;
+    memset(&args, 0, sizeof(args));
+    args.n_players = header.n_players;
+    args.n_characters = header.n_characters;
+    args.use_ash = header.use_ash;
+
+    // Seeded the same way main seeds new games
+    random_state rng;
+    seed_random(&rng, header.seed, 0);
+
+    summary->decisions = replay.num_keys;
+
+    NEW_GAME_RESULTS created;
+    game_manager *manager = new_game(args, game_map, rng, &replay.provider, NULL, &created);
+    if (created == NEW_GAME_OUT_OF_MEMORY) {
+        free_map(game_map);
+        free(log);
+        return map_error_at(error, 0, 0, "Not enough memory to replay the game");
+    } else if (manager == NULL) {
+        // A player exited while picking characters
+        summary->replayed.result = GAME_EXITED;
+        summary->replayed.round = 1;
+        summary->replayed.turn = 0;
+    } else {
+        summary->replayed = game_loop(manager);
+
+        if (summary->complete) {
+            game_state *state = new_game_state(game_map);
+            capture_game_state(manager, state);
+            summary->matches = !replay.ran_out && replay.position == replay.num_keys &&
+                               summary->replayed.result == summary->recorded.result &&
+                               summary->replayed.round == summary->recorded.round &&
+                               summary->replayed.turn == summary->recorded.turn &&
+                               hash_game_state(state) == trailer.state_hash;
+            free(state);
+        }
+
+        free_game(manager);
+    }
+    summary->decisions_used = replay.position;
+
+    free_map(game_map);
+    free(log);
+
+    return true;
+}
+
+/**
+ * Describe how a game ended
+ */
+const char *_result_name(GAME_RESULTS result)
+{
+    switch (result) {
+    case GAME_WON:
+        return "Won";
+    case GAME_LOST_MORALE:
+        return "Lost, morale dropped to 0";
+    case GAME_LOST_SELF_DESTRUCT:
+        return "Lost, self-destructed";
+    case GAME_EXITED:
+        return "Exited";
+    case GAME_ROUND_LIMIT:
+        return "Stopped at the round limit";
+    }
+
+    return "Unknown";
+}
+
+/**
+ * Print what a replay found
+ * @param out      Stream to print to
+ * @param summary  Summary filled in by replay_game
+ */
+void print_replay_summary(FILE *out, const replay_summary *summary)
+{
+    fprintf(out,
+            "Replayed %ld of %ld decisions: %s on round %d, turn %d\n",
+            summary->decisions_used,
+            summary->decisions,
+            _result_name(summary->replayed.result),
+            summary->replayed.round,
+            summary->replayed.turn + 1);
+
+    if (!summary->complete) {
+        fprintf(out, "The log ends before the game did, so there is no final state to check\n");
+    } else if (summary->matches) {
+        fprintf(out, "Final state matches the log\n");
+    } else {
+        fprintf(out,
+                "[ERROR] - Replay diverged from the log, which recorded: %s on round %d, turn %d\n",
+                _result_name(summary->recorded.result),
+                summary->recorded.round,
+                summary->recorded.turn + 1);
+    }
+}
@@ -0,0 +1,127 @@
+/**
+ * @file
+ * @date   16-Oct-2026
+ * @brief Driver code for aftn-sim - plays many games with bots and prints their results
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "arguments.h"
+#include "simulation.h"
+#include "sweep.h"
+
+const char *DEFAULT_MAP = "/var/games/aftn/game_data/maps/default";
+
+const char *argp_program_version = "aftn-sim 0.0.1";
+const char *argp_program_bug_address = "charles@utdallas.edu";
+static char doc[] = "Play many games of aftn with bots making random decisions, and summarize the results";
+
+static struct argp_option options[] = {
+    {"games",
+     'n',
+     "integer",
+     0,
+     "Number of games to play. With --sweep, the most games to play in each configuration"},
+    {"threads", 'j', "integer", 0, "Number of threads to play games on, defaults to the number of processors"},
+    {"n_characters", 'c', "integer", 0, "Number of characters in each game"},
+    {"use_ash", 'a', 0, 0, "Include Ash in each game"},
+    {"game",
+     'g',
+     "FILE",
+     0,
+     "Play on the game board at this path rather than the default. Compiled maps are accepted"},
+    {"max_rounds", 'r', "integer", 0, "Give up on games that last longer than this many rounds, 0 for no limit"},
+    {"load",
+     LOAD_KEY,
+     "FILE",
+     0,
+     "Start every game from the game saved in this file instead of a new game. Each game shuffles the "
+     "encounters left in the stack"},
+    {"seed",
+     SEED_KEY,
+     "integer",
+     0,
+     "Seed for every game's random events and bot decisions. Each game draws from its own random streams, so "
+     "the same seed gives the same results on any number of threads"},
+    {"sweep",
+     SWEEP_KEY,
+     "DIR",
+     0,
+     "Simulate every crew, with and without Ash, on every map in this directory, and print a CSV table of "
+     "their win rates instead of a summary"},
+    {"margin",
+     MARGIN_KEY,
+     "fraction",
+     0,
+     "With --sweep, play each configuration until the 95% confidence interval of its win rate is within this "
+     "much of it, defaults to 0.01"},
+    {0}};
+
+static struct argp argp = {options, parse_sim_opt, 0, doc, 0, 0, 0};
+
+int main(int argc, char *argv[])
+{
+    // Argument parsing
+    struct sim_arguments arguments;
+    arguments.game.n_players = 1;
+    arguments.game.n_characters = 1;
+    arguments.game.crew = 0;
+    arguments.game.use_ash = false;
+    strcpy(arguments.game.game_file, DEFAULT_MAP);
+    arguments.games = 10000;
+    arguments.threads = sysconf(_SC_NPROCESSORS_ONLN);
+    arguments.game.seed = 1;
+    arguments.game.load_file[0] = '\0';
+    arguments.max_rounds = 100;
+    arguments.sweep_dir[0] = '\0';
+    arguments.margin = 0.01;
+    argp_parse(&argp, argc, argv, 0, 0, &arguments);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    if (arguments.sweep_dir[0] != '\0') {
+        if (arguments.game.load_file[0] != '\0') {
+            fprintf(stderr, "[ERROR] - A sweep starts new games, so it can't be combined with --load\n");
+            exit(1);
+        }
+
+        map_error error;
+        if (!run_sweep(&arguments, stdout, &error)) {
+            print_map_error(arguments.sweep_dir, &error);
+            exit(1);
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        fprintf(stderr,
+                "Swept on %d threads in %.2f seconds\n",
+                arguments.threads,
+                (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9);
+
+        return 0;
+    }
+
+    simulation_results results;
+    map_error error;
+    if (!run_simulation(&arguments, &results, &error)) {
+        print_map_error(arguments.game.game_file, &error);
+        exit(1);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    print_simulation_results(stdout, &arguments, &results);
+    fprintf(stderr,
+            "Played %ld games on %d threads in %.2f seconds (%.0f games/s)\n",
+            results.games,
+            arguments.threads,
+            seconds,
+            results.games / seconds);
+
+    return 0;
+}
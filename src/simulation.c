@@ -0,0 +1,298 @@
+/**
+ * @file
+ * @date   16-Oct-2026
+ * @brief Logic for playing batches of games with bots across a pool of threads
+*/
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "game_state.h"
+#include "input.h"
+#include "simulation.h"
+
+// Number of games a worker claims at a time
+#define SIMULATION_CHUNK_SIZE 16
+
+// One thread of a simulation
+typedef struct simulation_worker {
+    const sim_arguments *args;
+    // Map every worker plays on
+    map *game_map;
+    // Saved game every game starts from, NULL to start new games
+    const game_state *start;
+    // Index of the next game no worker has claimed yet, shared by all workers
+    atomic_long *next_game;
+    // Index one past the last game to play
+    long last_game;
+
+    simulation_results results;
+} simulation_worker;
+
+/**
+ * Play one game with a random bot and add its outcome to `results`
+ * @param args        Simulation settings
+ * @param game_map    Map to play on
+ * @param start       Saved game to start from, NULL to start a new game
+ * @param game_index  Index of the game in the simulation, which picks its random streams
+ * @param results     Results to add the game to
+ */
+void simulate_game(const sim_arguments *args,
+                   map *game_map,
+                   const struct game_state *start,
+                   long game_index,
+                   simulation_results *results)
+{
+    // Every game draws from its own pair of streams, so it plays out the same way on any thread
+    random_state rng;
+    seed_random(&rng, args->game.seed, 2 * (uint64_t)game_index);
+    input_provider *bot = new_random_input(args->game.seed, 2 * (uint64_t)game_index + 1);
+
+    game_manager *manager;
+    NEW_GAME_RESULTS created = NEW_GAME_CREATED;
+    if (start != NULL) {
+        // Games from the same position only differ if they draw different cards
+        manager = new_game_from_state(start, game_map, bot, NULL);
+        if (manager != NULL) {
+            manager->rng = rng;
+            shuffle_encounters(&manager->encounters, &manager->rng);
+        } else {
+            created = NEW_GAME_OUT_OF_MEMORY;
+        }
+    } else {
+        manager = new_game(args->game, game_map, rng, bot, NULL, &created);
+    }
+    if (created == NEW_GAME_OUT_OF_MEMORY) {
+        results->out_of_memory++;
+        bot->free(bot);
+        return;
+    } else if (manager == NULL) {
+        // Bots never exit, but count it if one does
+        results->games++;
+        results->results[GAME_EXITED]++;
+        bot->free(bot);
+        return;
+    }
+
+    // Rounds before a saved game's position aren't recorded, and are left at -1
+    int morale_history[SIMULATION_MORALE_ROUNDS];
+    for (int i = 0; i < SIMULATION_MORALE_ROUNDS; i++) {
+        morale_history[i] = -1;
+    }
+    manager->max_rounds = args->max_rounds;
+    manager->morale_history = morale_history;
+    manager->morale_history_length = SIMULATION_MORALE_ROUNDS;
+
+    game_outcome outcome = game_loop(manager);
+    int rounds = outcome.round;
+
+    results->games++;
+    results->results[outcome.result]++;
+    results->total_rounds += rounds;
+
+    if (manager->is_final_mission) {
+        results->final_missions[manager->final_mission_type]++;
+        if (outcome.result == GAME_WON) {
+            results->final_mission_wins[manager->final_mission_type]++;
+        }
+    }
+
+    for (int i = 0; i < rounds && i < SIMULATION_MORALE_ROUNDS; i++) {
+        if (morale_history[i] < 0) {
+            continue;
+        }
+        results->morale_games[i]++;
+        results->morale_totals[i] += morale_history[i];
+    }
+
+    free_game(manager);
+    bot->free(bot);
+}
+
+/**
+ * Add the results of part of a simulation to a total
+ * @param total  Results to add to
+ * @param part   Results to add
+ */
+void add_simulation_results(simulation_results *total, const simulation_results *part)
+{
+    total->games += part->games;
+    for (int i = 0; i < NUM_GAME_RESULTS; i++) {
+        total->results[i] += part->results[i];
+    }
+    total->total_rounds += part->total_rounds;
+
+    for (int i = 0; i < NUM_FINAL_MISSIONS; i++) {
+        total->final_missions[i] += part->final_missions[i];
+        total->final_mission_wins[i] += part->final_mission_wins[i];
+    }
+
+    for (int i = 0; i < SIMULATION_MORALE_ROUNDS; i++) {
+        total->morale_games[i] += part->morale_games[i];
+        total->morale_totals[i] += part->morale_totals[i];
+    }
+
+    total->out_of_memory += part->out_of_memory;
+}
+
+/**
+ * Thread function of a simulation worker. Plays claimed games until none are left
+ * @param  arg                    The simulation_worker running on this thread
+ * @return          NULL
+ */
+void *_simulation_worker(void *arg)
+{
+    simulation_worker *worker = (simulation_worker *)arg;
+
+    while (1) {
+        long first = atomic_fetch_add(worker->next_game, SIMULATION_CHUNK_SIZE);
+        if (first >= worker->last_game) {
+            break;
+        }
+
+        long last = first + SIMULATION_CHUNK_SIZE;
+        if (last > worker->last_game) {
+            last = worker->last_game;
+        }
+
+        for (long i = first; i < last; i++) {
+            simulate_game(worker->args, worker->game_map, worker->start, i, &worker->results);
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Play the games from first_game up to last_game across a pool of threads, all on one copy of the map.
+ * Each game's index picks its random streams, so the results only depend on the settings, seed and range of
+ * games, not on the number of threads
+ * @param args        Simulation settings
+ * @param game_map    Map to play on
+ * @param start       Saved game every game starts from, NULL to start new games
+ * @param first_game  Index of the first game to play
+ * @param last_game   Index one past the last game to play
+ * @param results     Filled with the results of every game
+ */
+void simulate_games(const sim_arguments *args,
+                    map *game_map,
+                    const struct game_state *start,
+                    long first_game,
+                    long last_game,
+                    simulation_results *results)
+{
+    atomic_long next_game = first_game;
+
+    simulation_worker *workers = (simulation_worker *)calloc(args->threads, sizeof(simulation_worker));
+    pthread_t *threads = (pthread_t *)malloc(sizeof(pthread_t) * args->threads);
+    for (int i = 0; i < args->threads; i++) {
+        workers[i].args = args;
+        workers[i].game_map = game_map;
+        workers[i].start = start;
+        workers[i].next_game = &next_game;
+        workers[i].last_game = last_game;
+        pthread_create(&threads[i], NULL, _simulation_worker, &workers[i]);
+    }
+
+    memset(results, 0, sizeof(simulation_results));
+    for (int i = 0; i < args->threads; i++) {
+        pthread_join(threads[i], NULL);
+        add_simulation_results(results, &workers[i].results);
+    }
+
+    free(threads);
+    free(workers);
+}
+
+/**
+ * Play a batch of games across a pool of threads, see simulate_games
+ * @param  args                   Simulation settings
+ * @param  results                Filled with the results of every game
+ * @param  error                  Filled with the reason the map or saved game couldn't be loaded, if it couldn't
+ * @return          True if the games were played, false if the map or saved game couldn't be loaded, or
+ *                  there wasn't enough memory for a game
+ */
+bool run_simulation(const sim_arguments *args, simulation_results *results, map_error *error)
+{
+    map *game_map = read_map(args->game.game_file, error);
+    if (game_map == NULL) {
+        return false;
+    }
+
+    game_state *start = NULL;
+    if (args->game.load_file[0] != '\0') {
+        start = load_game_state(args->game.load_file, game_map, error);
+        if (start == NULL) {
+            char reason[sizeof(error->message)];
+            strcpy(reason, error->message);
+            map_error_at(error, 0, 0, "Could not load saved game %s: %s", args->game.load_file, reason);
+            free_map(game_map);
+            return false;
+        }
+    }
+
+    simulate_games(args, game_map, start, 0, args->games, results);
+
+    free(start);
+    free_map(game_map);
+
+    if (results->out_of_memory > 0) {
+        return map_error_at(error, 0, 0, "Not enough memory for %ld of the games", results->out_of_memory);
+    }
+
+    return true;
+}
+
+/**
+ * Print a percentage of the games of a simulation
+ */
+void _print_share(FILE *out, const char *label, long count, long games)
+{
+    fprintf(out, "%-28s %10ld  (%6.2f%%)\n", label, count, games > 0 ? 100.0 * count / games : 0.0);
+}
+
+/**
+ * Print a summary of the results of a simulation
+ * @param out      Stream to print to
+ * @param args     Settings the simulation was run with
+ * @param results  Results to print
+ */
+void print_simulation_results(FILE *out, const sim_arguments *args, const simulation_results *results)
+{
+    fprintf(out, "---RESULTS---\n");
+    fprintf(out, "%-28s %10ld\n", "Games", results->games);
+    _print_share(out, "Won", results->results[GAME_WON], results->games);
+    _print_share(out, "Lost, morale dropped to 0", results->results[GAME_LOST_MORALE], results->games);
+    _print_share(out, "Lost, self-destructed", results->results[GAME_LOST_SELF_DESTRUCT], results->games);
+    if (args->max_rounds > 0) {
+        char label[64];
+        snprintf(label, sizeof(label), "Unfinished after %d rounds", args->max_rounds);
+        _print_share(out, label, results->results[GAME_ROUND_LIMIT], results->games);
+    }
+    fprintf(out,
+            "%-28s %10.2f\n",
+            "Average rounds",
+            results->games > 0 ? (double)results->total_rounds / results->games : 0.0);
+
+    fprintf(out, "\n---FINAL MISSIONS---\n");
+    for (int i = 0; i < NUM_FINAL_MISSIONS; i++) {
+        fprintf(out,
+                "%-32s drawn %10ld  (%6.2f%%)  won %10ld  (%6.2f%%)\n",
+                final_mission_names[i],
+                results->final_missions[i],
+                results->games > 0 ? 100.0 * results->final_missions[i] / results->games : 0.0,
+                results->final_mission_wins[i],
+                results->final_missions[i] > 0 ? 100.0 * results->final_mission_wins[i] / results->final_missions[i]
+                                               : 0.0);
+    }
+
+    fprintf(out, "\n---MORALE---\n");
+    fprintf(out, "Round    Games  Average morale at start of round\n");
+    for (int i = 0; i < SIMULATION_MORALE_ROUNDS && results->morale_games[i] > 0; i++) {
+        fprintf(out,
+                "%5d %8ld  %6.2f\n",
+                i + 1,
+                results->morale_games[i],
+                (double)results->morale_totals[i] / results->morale_games[i]);
+    }
+}
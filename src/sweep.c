@@ -0,0 +1,273 @@
+/**
+ * @file
+ * @date   16-Oct-2026
+ * @brief Logic for sweeping simulations over every crew, with and without Ash, on a directory of maps
+*/
+
+#include <dirent.h>
+#include <errno.h>
+#include <math.h>
+#include <sys/stat.h>
+
+#include "character.h"
+#include "sweep.h"
+
+/**
+ * 95% Wilson score interval of a win rate, which stays sensible for win rates near 0 or 1
+ * @param wins   Number of games won
+ * @param games  Number of games played
+ * @param low    Set to the lower end of the interval
+ * @param high   Set to the upper end of the interval
+ */
+void wilson_interval(long wins, long games, double *low, double *high)
+{
+    if (games <= 0) {
+        *low = 0;
+        *high = 1;
+        return;
+    }
+
+    double z2 = SWEEP_Z * SWEEP_Z;
+    double p = (double)wins / games;
+    double scale = 1 + z2 / games;
+    double center = (p + z2 / (2.0 * games)) / scale;
+    double half_width = SWEEP_Z * sqrt(p * (1 - p) / games + z2 / (4.0 * games * games)) / scale;
+
+    *low = fmax(0, center - half_width);
+    *high = fmin(1, center + half_width);
+}
+
+/**
+ * Play batches of games in one configuration until the confidence interval of its win rate is within
+ * args->margin, or args->games games have been played. Batches are sized from the win rate so far, so
+ * lopsided configurations finish early. Which games are played only depends on the settings and seed
+ * @param args      Settings of the configuration
+ * @param game_map  Map to play on
+ * @param results   Filled with the results of every game played. Stops early if a game runs out of memory
+ */
+void sweep_configuration(const sim_arguments *args, map *game_map, simulation_results *results)
+{
+    memset(results, 0, sizeof(simulation_results));
+
+    long target = args->games < SWEEP_FIRST_BATCH ? args->games : SWEEP_FIRST_BATCH;
+    while (results->games < args->games) {
+        simulation_results batch;
+        simulate_games(args, game_map, NULL, results->games, target, &batch);
+        add_simulation_results(results, &batch);
+        if (batch.out_of_memory > 0) {
+            break;
+        }
+
+        double low, high;
+        wilson_interval(results->results[GAME_WON], results->games, &low, &high);
+        if ((high - low) / 2 <= args->margin) {
+            break;
+        }
+
+        // Games a normal interval around the Agresti-Coull estimate of the win rate needs to be within margin
+        double z2 = SWEEP_Z * SWEEP_Z;
+        double p = (results->results[GAME_WON] + z2 / 2) / (results->games + z2);
+        long needed = (long)ceil(z2 * p * (1 - p) / (args->margin * args->margin));
+
+        target = needed > results->games + SWEEP_FIRST_BATCH ? needed : results->games + SWEEP_FIRST_BATCH;
+        if (target > args->games) {
+            target = args->games;
+        }
+    }
+}
+
+/**
+ * Number of characters in a crew
+ */
+int _crew_size(int crew)
+{
+    int size = 0;
+    for (int i = 0; i < 5; i++) {
+        size += (crew >> i) & 1;
+    }
+
+    return size;
+}
+
+/**
+ * Print a string as a quoted CSV field
+ */
+void _print_csv_string(FILE *out, const char *str)
+{
+    fputc('"', out);
+    for (const char *c = str; *c != '\0'; c++) {
+        if (*c == '"') {
+            fputc('"', out);
+        }
+        fputc(*c, out);
+    }
+    fputc('"', out);
+}
+
+/**
+ * Print one configuration of a sweep as a row of its CSV table
+ */
+void _print_sweep_row(FILE *out, const map *game_map, const sim_arguments *config, const simulation_results *results)
+{
+    char crew[64] = "";
+    for (int i = 0; i < 5; i++) {
+        if (config->game.crew & (1 << i)) {
+            if (crew[0] != '\0') {
+                strcat(crew, " ");
+            }
+            strcat(crew, default_characters[i].last_name);
+        }
+    }
+
+    long wins = results->results[GAME_WON];
+    double low, high;
+    wilson_interval(wins, results->games, &low, &high);
+
+    _print_csv_string(out, game_map->name);
+    fputc(',', out);
+    _print_csv_string(out, config->game.game_file);
+    fputc(',', out);
+    _print_csv_string(out, crew);
+    fprintf(out,
+            ",%d,%d,%ld,%ld,%.6f,%.6f,%.6f,%ld,%ld,%ld,%.3f\n",
+            config->game.n_characters,
+            config->game.use_ash,
+            results->games,
+            wins,
+            results->games > 0 ? (double)wins / results->games : 0.0,
+            low,
+            high,
+            results->results[GAME_LOST_MORALE],
+            results->results[GAME_LOST_SELF_DESTRUCT],
+            results->results[GAME_ROUND_LIMIT],
+            results->games > 0 ? (double)results->total_rounds / results->games : 0.0);
+}
+
+/**
+ * Order paths for qsort
+ */
+int _compare_paths(const void *a, const void *b)
+{
+    return strcmp(*(const char **)a, *(const char **)b);
+}
+
+/**
+ * List the regular files in a directory, sorted by name so sweeps visit maps in the same order everywhere
+ * @param  dir_name               Directory to list
+ * @param  num_files              Set to the number of files
+ * @return          Newly allocated array of newly allocated paths, NULL if the directory can't be opened
+ */
+char **_list_files(const char *dir_name, int *num_files)
+{
+    DIR *dir = opendir(dir_name);
+    if (dir == NULL) {
+        return NULL;
+    }
+
+    int capacity = 16;
+    char **files = (char **)malloc(sizeof(char *) * capacity);
+    *num_files = 0;
+
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+
+        char path[256];
+        struct stat info;
+        if (snprintf(path, sizeof(path), "%s/%s", dir_name, entry->d_name) >= (int)sizeof(path) ||
+            stat(path, &info) != 0 || !S_ISREG(info.st_mode)) {
+            continue;
+        }
+
+        if (*num_files == capacity) {
+            capacity *= 2;
+            files = (char **)realloc(files, sizeof(char *) * capacity);
+        }
+        files[(*num_files)++] = strdup(path);
+    }
+    closedir(dir);
+
+    qsort(files, *num_files, sizeof(char *), _compare_paths);
+
+    return files;
+}
+
+/**
+ * Simulate every crew, with and without Ash, on every map in args->sweep_dir, and write a CSV table of their
+ * win rates with 95% confidence intervals. Each configuration plays until its interval is within args->margin,
+ * or for args->games games. Rows are written as configurations finish, so long sweeps can be watched. Files
+ * in the directory that aren't maps are skipped with a warning
+ * @param  args                   Simulation settings, the crew and Ash settings are ignored
+ * @param  out                    Stream to write the table to
+ * @param  error                  Filled with the reason the sweep couldn't run, if it couldn't
+ * @return          True if at least one map was swept, false if none were or a game ran out of memory
+ */
+bool run_sweep(const sim_arguments *args, FILE *out, map_error *error)
+{
+    int num_files;
+    char **files = _list_files(args->sweep_dir, &num_files);
+    if (files == NULL) {
+        return map_error_at(error, 0, 0, "Failed to open map directory: %s", strerror(errno));
+    }
+
+    fprintf(out,
+            "map,file,crew,characters,ash,games,wins,win_rate,win_rate_low,win_rate_high,lost_morale,"
+            "lost_self_destruct,unfinished,average_rounds\n");
+
+    int num_maps = 0;
+    for (int i = 0; i < num_files; i++) {
+        map_error reason;
+        map *game_map = read_map(files[i], &reason);
+        if (game_map == NULL) {
+            fprintf(stderr, "[WARNING] - Skipping %s, it isn't a map: %s\n", files[i], reason.message);
+            free(files[i]);
+            continue;
+        }
+        num_maps++;
+
+        sim_arguments config = *args;
+        strcpy(config.game.game_file, files[i]);
+        config.game.load_file[0] = '\0';
+
+        for (int ash = 0; ash <= 1; ash++) {
+            for (int size = 1; size <= 5; size++) {
+                for (int crew = 1; crew <= SWEEP_CREWS; crew++) {
+                    if (_crew_size(crew) != size) {
+                        continue;
+                    }
+
+                    config.game.use_ash = ash;
+                    config.game.n_characters = size;
+                    config.game.crew = crew;
+
+                    simulation_results results;
+                    sweep_configuration(&config, game_map, &results);
+                    if (results.out_of_memory > 0) {
+                        free_map(game_map);
+                        for (int j = i; j < num_files; j++) {
+                            free(files[j]);
+                        }
+                        free(files);
+                        return map_error_at(
+                            error, 0, 0, "Not enough memory for the games on %s", config.game.game_file);
+                    }
+                    _print_sweep_row(out, game_map, &config, &results);
+                    fflush(out);
+                }
+            }
+        }
+
+        fprintf(stderr, "Swept %s\n", files[i]);
+        free_map(game_map);
+        free(files[i]);
+    }
+    free(files);
+
+    if (num_maps == 0) {
+        return map_error_at(error, 0, 0, "No maps found in %s", args->sweep_dir);
+    }
+
+    return true;
+}
@@ -8,14 +8,71 @@
 #include "utils.h"
 
 /**
- * Return a random integer in [low, high]
+ * Seed a random number generator. Generators seeded with the same seed and stream produce the same
+ * numbers, and generators on different streams produce unrelated numbers even with the same seed
+ * @param rng     Generator to seed
+ * @param seed    Starting point within the stream
+ * @param stream  Which stream to draw from, only the low 63 bits are used
+ */
+void seed_random(random_state *rng, uint64_t seed, uint64_t stream)
+{
+    rng->state = 0;
+    rng->increment = (stream << 1) | 1;
+    random_next(rng);
+    rng->state += seed;
+    random_next(rng);
+}
+
+/**
+ * Advance a random number generator
+ * @param  rng                Generator to advance
+ * @return      A uniformly random 32-bit integer
+ */
+uint32_t random_next(random_state *rng)
+{
+    uint64_t old_state = rng->state;
+    rng->state = old_state * 6364136223846793005ull + rng->increment;
+
+    // PCG XSH RR output permutation
+    uint32_t xorshifted = ((old_state >> 18) ^ old_state) >> 27;
+    uint32_t rotation = old_state >> 59;
+    return (xorshifted >> rotation) | (xorshifted << (-rotation & 31));
+}
+
+/**
+ * Return a uniformly random integer in [0, bound) without modulo bias, using Lemire's multiply and
+ * reject method. Most draws need a single multiplication and no division
+ * @param  rng                Generator to draw from
+ * @param  bound              Exclusive upper bound, must be positive
+ * @return      A random integer in [0, bound)
+ */
+uint32_t random_below(random_state *rng, uint32_t bound)
+{
+    uint64_t product = (uint64_t)random_next(rng) * bound;
+    uint32_t low_bits = (uint32_t)product;
+
+    if (low_bits < bound) {
+        // Reject the few products that would make some results more likely than others
+        uint32_t threshold = -bound % bound;
+        while (low_bits < threshold) {
+            product = (uint64_t)random_next(rng) * bound;
+            low_bits = (uint32_t)product;
+        }
+    }
+
+    return product >> 32;
+}
+
+/**
+ * Return a uniformly random integer in [low, high]
+ * @param  rng                Generator to draw from
  * @param  low                Low bound, inclusive
  * @param  high               High bound, inclusive
  * @return      A random integer in [low, high]
  */
-int randint(int low, int high)
+int randint(random_state *rng, int low, int high)
 {
-    return (rand() % (high - low + 1)) + low;
+    return low + (int)random_below(rng, (uint32_t)(high - low) + 1);
 }
 
 /**
@@ -93,53 +150,85 @@ int min(int a, int b)
 
 /**
  * Read character from stdin
- * @return Input character
+ * @return Input character, '\0' if stdin has closed
  */
 char get_character()
 {
     char *line = NULL;
     size_t len = 0;
-    getline(&line, &len, stdin);
-
-    char ch = line[0];
+    char ch = getline(&line, &len, stdin) != -1 ? line[0] : '\0';
     free(line);
 
     return ch;
 }
 
 /**
- * Initialize a new room_queue
- * @param  capacity               Maximum capacity of queue
+ * Bytes a room_queue and its storage take up
+ * @param  capacity               Maximum capacity of the queue
+ * @return          Size of the queue in bytes
+ */
+size_t room_queue_size(int capacity)
+{
+    return sizeof(struct room_queue) + sizeof(room *) * capacity + sizeof(uint64_t) * ((capacity + 63) / 64);
+}
+
+/**
+ * Initialize a new room_queue. The queue and its storage are one allocation, release it with free()
+ * @param  capacity               Maximum capacity of queue, and one more than the largest room id it may hold
  * @return          A pointer to an initialized room_queue
  */
 struct room_queue *new_room_queue(int capacity)
 {
-    struct room_queue *q;
-    q = malloc(sizeof(struct room_queue));
-
-    if (q == NULL) {
-        return q;
+    void *memory = malloc(room_queue_size(capacity));
+    if (memory == NULL) {
+        return NULL;
     }
 
+    return init_room_queue(memory, capacity);
+}
+
+/**
+ * Lay out an empty room_queue in a block of memory
+ * @param  memory                 Block of at least room_queue_size(capacity) bytes, aligned like memory from malloc
+ * @param  capacity               Maximum capacity of queue, and one more than the largest room id it may hold
+ * @return          A pointer to the room_queue, at the start of the block
+ */
+struct room_queue *init_room_queue(void *memory, int capacity)
+{
+    int member_words = (capacity + 63) / 64;
+
+    struct room_queue *q = (struct room_queue *)memory;
+
     q->size = 0;
     q->max_size = capacity;
-    q->head = NULL;
-    q->tail = NULL;
+    q->head = 0;
+    q->rooms = (room **)(q + 1);
+    q->members = (uint64_t *)(q->rooms + capacity);
+    memset(q->members, 0, sizeof(uint64_t) * member_words);
 
     return q;
 }
 
+/**
+ * Remove every room from a room_queue
+ * @param q  Queue to clear
+ */
+void clear_queue(struct room_queue *q)
+{
+    while (q->size > 0) {
+        pop(q);
+    }
+    q->head = 0;
+}
+
 /**
  * Prints a queue's elements
  * @param q  Queue to print
  */
 void print_queue(struct room_queue *q)
 {
-    room *tmp = q->head;
-
-    while (tmp != NULL) {
-        printf("%s ", tmp->name);
-        tmp = tmp->room_queue_next;
+    for (int i = 0; i < q->size; i++) {
+        printf("%s ", poll_position(q, i)->name);
     }
 
     printf("\n");
@@ -157,22 +246,18 @@ int push(struct room_queue *q, room *node)
         return q->size;
     }
 
-    if (node == NULL) {
+    // Rooms whose ids don't fit in the membership bitset can't be tracked, so they're never queued
+    if (node == NULL || node->id < 0 || node->id >= q->max_size || queue_contains(q, node)) {
         return q->size;
     }
 
-    node->room_queue_next = NULL;
-
-    if (q->head == NULL) {
-        q->head = node;
-        q->tail = node;
-        q->size = 1;
-
-        return q->size;
+    int tail = q->head + q->size;
+    if (tail >= q->max_size) {
+        tail -= q->max_size;
     }
 
-    q->tail->room_queue_next = node;
-    q->tail = node;
+    q->rooms[tail] = node;
+    q->members[node->id / 64] |= (uint64_t)1 << (node->id % 64);
     q->size += 1;
 
     return q->size;
@@ -189,8 +274,12 @@ room *pop(struct room_queue *q)
         return NULL;
     }
 
-    room *tmp = q->head;
-    q->head = q->head->room_queue_next;
+    room *tmp = q->rooms[q->head];
+    q->members[tmp->id / 64] &= ~((uint64_t)1 << (tmp->id % 64));
+    q->head += 1;
+    if (q->head == q->max_size) {
+        q->head = 0;
+    }
     q->size -= 1;
 
     return tmp;
@@ -207,14 +296,9 @@ room *pop_tail(struct room_queue *q)
         return NULL;
     }
 
-    room *tmp = q->head;
-    while (tmp->room_queue_next != q->tail && tmp->room_queue_next->room_queue_next != NULL) {
-        tmp = tmp->room_queue_next;
-    }
-    room *out = tmp->room_queue_next;
-    tmp->room_queue_next = NULL;
-
-    q->tail = tmp;
+    room *tmp = poll_position(q, q->size - 1);
+    q->members[tmp->id / 64] &= ~((uint64_t)1 << (tmp->id % 64));
+    q->size -= 1;
 
     return tmp;
 }
@@ -227,19 +311,17 @@ room *pop_tail(struct room_queue *q)
  */
 room *poll_position(room_queue *q, int i)
 {
-    if (i >= q->size) {
+    if (i < 0 || i >= q->size) {
         fprintf(stderr, "poll_position caused out-of-bounds access\n");
         exit(1);
     }
 
-    room *tmp = q->head;
-    int index = 0;
-    while (index != i) {
-        tmp = tmp->room_queue_next;
-        index++;
+    int index = q->head + i;
+    if (index >= q->max_size) {
+        index -= q->max_size;
     }
 
-    return tmp;
+    return q->rooms[index];
 }
 
 /**
@@ -250,12 +332,52 @@ room *poll_position(room_queue *q, int i)
  */
 bool queue_contains(struct room_queue *q, room *target)
 {
-    room *tmp = q->head;
-    while (tmp != NULL) {
-        if (tmp == target) {
-            return true;
-        }
-        tmp = tmp->room_queue_next;
+    if (target == NULL || target->id < 0 || target->id >= q->max_size) {
+        return false;
     }
-    return false;
+
+    return (q->members[target->id / 64] >> (target->id % 64)) & 1;
+}
+
+/**
+ * Set up an arena over a block of memory
+ * @param a         Arena to set up
+ * @param memory    Block to allocate from, aligned to ARENA_ALIGNMENT, like memory from malloc
+ * @param capacity  Size of the block in bytes
+ */
+void init_arena(arena *a, void *memory, size_t capacity)
+{
+    a->memory = (char *)memory;
+    a->capacity = capacity;
+    a->used = 0;
+}
+
+/**
+ * Allocate from an arena. Arenas are sized for everything they will hold, so running out is a bug
+ * @param  a                      Arena to allocate from
+ * @param  size                   Number of bytes to allocate
+ * @return          Pointer to the uninitialized allocation, aligned to ARENA_ALIGNMENT
+ */
+void *arena_alloc(arena *a, size_t size)
+{
+    size = ARENA_SIZE(size);
+    if (size > a->capacity - a->used) {
+        fprintf(stderr, "[ERROR] - Arena of %zu bytes can't fit another %zu bytes\n", a->capacity, size);
+        exit(1);
+    }
+
+    void *out = a->memory + a->used;
+    a->used += size;
+
+    return out;
+}
+
+/**
+ * Release everything allocated from an arena since it was at a mark
+ * @param a     Arena to reset
+ * @param mark  Value of a->used to return to, 0 to release everything
+ */
+void reset_arena(arena *a, size_t mark)
+{
+    a->used = mark;
 }
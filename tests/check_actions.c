@@ -0,0 +1,190 @@
+/**
+ * @file
+ * @date   16-Oct-2026
+ * @brief Check that the keys of every action get_legal_actions lists take that action. Bots play games, and
+ *        at every action menu each listed action is played from a copy of the game
+*/
+
+#include "action.h"
+#include "game_state.h"
+#include "input.h"
+#include "manager.h"
+
+// Rounds each bot game is played for
+#define CHECK_ROUNDS 30
+
+// Answers the menus of one action with its keys, then stops the game at the next decision
+typedef struct action_input {
+    input_provider provider;
+
+    const char *keys;
+    int position;
+    // The game before the action was taken
+    const game_state *before;
+
+    // Set if a key wasn't one of the menu's options
+    bool rejected;
+    // Set once every key was answered, and whether the game changed by then
+    bool finished;
+    bool changed;
+} action_input;
+
+// Plays a game with a random bot, checking the legal actions at every action menu
+typedef struct checking_input {
+    input_provider provider;
+
+    input_provider *bot;
+    map *game_map;
+    search_scratch *scratch;
+
+    long menus;
+    long actions;
+    long failures;
+} checking_input;
+
+/**
+ * Answer with the next key of the action, and stop the game once they run out
+ */
+char _action_choose(input_provider *self, struct game_manager *manager, DECISION_TYPES decision, const char *options)
+{
+    action_input *input = (action_input *)self;
+
+    if (input->keys[input->position] != '\0') {
+        char key = input->keys[input->position++];
+        if (strchr(options, key) == NULL) {
+            input->rejected = true;
+            end_game(manager, GAME_EXITED);
+        }
+        return key;
+    }
+
+    game_state *after = new_game_state(manager->game_map);
+    capture_game_state(manager, after);
+    input->finished = true;
+    input->changed = !game_states_equal(after, input->before);
+    free(after);
+
+    end_game(manager, GAME_EXITED);
+
+    return '\0';
+}
+
+/**
+ * Play every legal action of the state from a copy of the game
+ * @return  Number of actions that failed
+ */
+int _check_actions(checking_input *check, const game_state *state)
+{
+    game_action actions[MAX_LEGAL_ACTIONS];
+    int num_actions = get_legal_actions(state, check->game_map, check->scratch, actions);
+
+    int failures = 0;
+    for (int i = 0; i < num_actions; i++) {
+        action_input input;
+        memset(&input, 0, sizeof(input));
+        input.provider.choose = _action_choose;
+        input.keys = actions[i].keys;
+        input.before = state;
+
+        game_manager *game = new_game_from_state(state, check->game_map, &input.provider, NULL);
+        if (game == NULL) {
+            fprintf(stderr, "[ERROR] - Not enough memory for a game\n");
+            exit(1);
+        }
+        game_loop(game);
+
+        // Actions that end the game, like dropping the last COOLANT CANISTER needed to win, never finish
+        if (input.rejected || (input.finished && !input.changed)) {
+            fprintf(stderr,
+                    "[ERROR] - Round %d, turn %d: action %d of type %d with keys %s %s\n",
+                    state->round_index,
+                    state->turn_index,
+                    i,
+                    actions[i].type,
+                    actions[i].keys,
+                    input.rejected ? "has a key the menus don't offer" : "doesn't change the game");
+            failures++;
+        }
+        free_game(game);
+    }
+
+    check->actions += num_actions;
+
+    return failures;
+}
+
+/**
+ * Check the legal actions at action menus, and let the bot answer every decision
+ */
+char _checking_choose(input_provider *self, struct game_manager *manager, DECISION_TYPES decision, const char *options)
+{
+    checking_input *check = (checking_input *)self;
+
+    if (decision == DECISION_ACTION) {
+        game_state *state = new_game_state(manager->game_map);
+        capture_game_state(manager, state);
+        check->failures += _check_actions(check, state);
+        check->menus++;
+        free(state);
+    }
+
+    return check->bot->choose(check->bot, manager, decision, options);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s MAP [GAMES]\n", argv[0]);
+        return 1;
+    }
+    int games = argc > 2 ? atoi(argv[2]) : 50;
+
+    map_error error;
+    map *game_map = read_map(argv[1], &error);
+    if (game_map == NULL) {
+        print_map_error(argv[1], &error);
+        return 1;
+    }
+
+    checking_input check;
+    memset(&check, 0, sizeof(check));
+    check.provider.choose = _checking_choose;
+    check.game_map = game_map;
+    check.scratch = new_search_scratch(game_map);
+
+    for (int i = 0; i < games; i++) {
+        check.bot = new_random_input(i, 1);
+
+        // Every character, with and without Ash
+        arguments args;
+        memset(&args, 0, sizeof(args));
+        args.n_players = 1;
+        args.n_characters = 5;
+        args.use_ash = i % 2;
+
+        random_state rng;
+        seed_random(&rng, i, 0);
+        NEW_GAME_RESULTS created;
+        game_manager *game = new_game(args, game_map, rng, &check.provider, NULL, &created);
+        if (game == NULL) {
+            fprintf(stderr, "[ERROR] - Not enough memory for a game\n");
+            return 1;
+        }
+        game->max_rounds = CHECK_ROUNDS;
+        game_loop(game);
+
+        free_game(game);
+        check.bot->free(check.bot);
+    }
+
+    printf("Checked %ld actions at %ld action menus in %d games, %ld failed\n",
+           check.actions,
+           check.menus,
+           games,
+           check.failures);
+
+    free_search_scratch(check.scratch);
+    free_map(game_map);
+
+    return check.failures > 0;
+}
@@ -0,0 +1,206 @@
+/**
+ * @file
+ * @date   16-Oct-2026
+ * @brief Check the encounter odds against counting every way the cards can be drawn, for every makeup of the
+ *        encounter stack
+*/
+
+#include <math.h>
+
+#include "map/encounter.h"
+
+// Most cards left in a stack for which every set of draws is counted to check the chance of an alien card
+#define CHECK_SUBSET_CARDS 12
+
+// Odds are compared with this tolerance, they are sums of a few hundred terms at most
+#define CHECK_TOLERANCE 1e-12
+
+/**
+ * Index of a mix in encounter_mixes
+ */
+int _mix_index(const encounter_mix *mixes, int num_mixes, const int8_t *counts)
+{
+    for (int i = 0; i < num_mixes; i++) {
+        if (memcmp(mixes[i].counts, counts, sizeof(mixes[i].counts)) == 0) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * Draw every sequence of `draws - depth` more cards from the stack, adding one to the mix each ends with
+ */
+void _count_sequences(const encounter_stack *stack,
+                      int draws,
+                      int depth,
+                      bool *used,
+                      int8_t *counts,
+                      double *sequences_by_mix)
+{
+    if (depth == draws) {
+        int num_mixes;
+        const encounter_mix *mixes = encounter_mixes(draws, &num_mixes);
+        sequences_by_mix[_mix_index(mixes, num_mixes, counts)]++;
+        return;
+    }
+
+    for (int i = 0; i < stack->num_encounters; i++) {
+        if (used[i]) {
+            continue;
+        }
+        used[i] = true;
+        counts[(int)stack->encounters[i]]++;
+        _count_sequences(stack, draws, depth + 1, used, counts, sequences_by_mix);
+        counts[(int)stack->encounters[i]]--;
+        used[i] = false;
+    }
+}
+
+/**
+ * Compare get_encounter_odds to drawing every sequence of cards from the stack
+ * @return  Number of odds that are wrong
+ */
+int _check_odds(const encounter_stack *stack, int draws)
+{
+    int num_mixes;
+    const encounter_mix *mixes = encounter_mixes(draws, &num_mixes);
+
+    // Every ordered choice of `draws` different cards is as likely as any other
+    double expected[ENCOUNTER_MAX_MIXES] = {0};
+    bool used[ENCOUNTER_STACK_SIZE] = {false};
+    int8_t drawn[NUM_ENCOUNTER_TYPES] = {0};
+    _count_sequences(stack, draws, 0, used, drawn, expected);
+
+    double sequences = 0;
+    for (int i = 0; i < num_mixes; i++) {
+        sequences += expected[i];
+    }
+
+    const encounter_odds *odds = get_encounter_odds(stack, draws);
+    int wrong = odds->draws != draws || odds->num_mixes != num_mixes || get_encounter_odds(stack, draws) != odds;
+
+    double expected_chance[ENCOUNTER_ODDS_MAX_DRAWS + 1][ENCOUNTER_ODDS_MAX_DRAWS + 1] = {{0}};
+    double expected_by_type[NUM_ENCOUNTER_TYPES][ENCOUNTER_ODDS_MAX_DRAWS + 1] = {{0}};
+    for (int i = 0; i < num_mixes; i++) {
+        expected[i] /= sequences;
+        wrong += fabs(odds->mixes[i] - expected[i]) > CHECK_TOLERANCE;
+
+        const int8_t *counts = mixes[i].counts;
+        int aliens = counts[ALIEN_Lost_The_Signal] + counts[ALIEN_Stalk] + counts[ALIEN_Hunt];
+        int order937s = counts[ORDER937_Meet_Me_In_The_Infirmary] + counts[ORDER937_Crew_Expendable] +
+                        counts[ORDER937_Collating_Data];
+        expected_chance[aliens][order937s] += expected[i];
+        for (int type = 0; type < NUM_ENCOUNTER_TYPES; type++) {
+            expected_by_type[type][counts[type]] += expected[i];
+        }
+    }
+    for (int a = 0; a <= ENCOUNTER_ODDS_MAX_DRAWS; a++) {
+        for (int o = 0; o <= ENCOUNTER_ODDS_MAX_DRAWS; o++) {
+            wrong += fabs(odds->chance[a][o] - expected_chance[a][o]) > CHECK_TOLERANCE;
+        }
+    }
+    for (int type = 0; type < NUM_ENCOUNTER_TYPES; type++) {
+        for (int c = 0; c <= ENCOUNTER_ODDS_MAX_DRAWS; c++) {
+            wrong += fabs(odds->by_type[type][c] - expected_by_type[type][c]) > CHECK_TOLERANCE;
+        }
+    }
+
+    return wrong;
+}
+
+/**
+ * Compare alien_encounter_chance and encounter_type_chance to every set of cards that can be drawn from a
+ * small stack
+ * @return  Number of chances that are wrong
+ */
+int _check_chances(const encounter_stack *stack)
+{
+    int left = stack->num_encounters;
+
+    long sets[ENCOUNTER_STACK_SIZE + 1] = {0};
+    long with_alien[ENCOUNTER_STACK_SIZE + 1] = {0};
+    long with_type[NUM_ENCOUNTER_TYPES][ENCOUNTER_STACK_SIZE + 1] = {{0}};
+    for (long set = 0; set < (1L << left); set++) {
+        int draws = 0;
+        bool alien = false;
+        bool types[NUM_ENCOUNTER_TYPES] = {false};
+        for (int i = 0; i < left; i++) {
+            if (set & (1L << i)) {
+                draws++;
+                alien |= stack->encounters[i] >= ALIEN_Lost_The_Signal && stack->encounters[i] <= ALIEN_Hunt;
+                types[(int)stack->encounters[i]] = true;
+            }
+        }
+
+        sets[draws]++;
+        with_alien[draws] += alien;
+        for (int type = 0; type < NUM_ENCOUNTER_TYPES; type++) {
+            with_type[type][draws] += types[type];
+        }
+    }
+
+    int wrong = 0;
+    for (int draws = 0; draws <= left; draws++) {
+        wrong += fabs(alien_encounter_chance(stack, draws) - (double)with_alien[draws] / sets[draws]) > CHECK_TOLERANCE;
+        for (int type = 0; type < NUM_ENCOUNTER_TYPES; type++) {
+            wrong += fabs(encounter_type_chance(stack, type, draws) - (double)with_type[type][draws] / sets[draws]) >
+                     CHECK_TOLERANCE;
+        }
+    }
+
+    return wrong;
+}
+
+int main(void)
+{
+    int in_deck[NUM_ENCOUNTER_TYPES] = {0};
+    for (int i = 0; i < ENCOUNTER_STACK_SIZE; i++) {
+        in_deck[encounter_deck[i]]++;
+    }
+
+    // Visit every makeup, counting up the cards of each type like the digits of a number
+    int counts[NUM_ENCOUNTER_TYPES] = {0};
+    long makeups = 0;
+    long wrong = 0;
+    while (true) {
+        encounter_stack stack;
+        memset(&stack, 0, sizeof(stack));
+        for (int type = 0; type < NUM_ENCOUNTER_TYPES; type++) {
+            for (int i = 0; i < counts[type]; i++) {
+                stack.encounters[stack.num_encounters++] = type;
+            }
+            stack.remaining[type] = counts[type];
+            stack.discarded[type] = in_deck[type] - counts[type];
+        }
+
+        for (int draws = 0; draws <= min(stack.num_encounters, ENCOUNTER_ODDS_MAX_DRAWS); draws++) {
+            wrong += _check_odds(&stack, draws);
+        }
+        if (stack.num_encounters <= CHECK_SUBSET_CARDS) {
+            wrong += _check_chances(&stack);
+        }
+        makeups++;
+
+        int type = 0;
+        while (type < NUM_ENCOUNTER_TYPES && counts[type] == in_deck[type]) {
+            counts[type++] = 0;
+        }
+        if (type == NUM_ENCOUNTER_TYPES) {
+            break;
+        }
+        counts[type]++;
+    }
+
+    printf("Checked the encounter odds of %ld stack makeups, %ld were wrong\n", makeups, wrong);
+    if (makeups != NUM_ENCOUNTER_MAKEUPS) {
+        fprintf(stderr,
+                "[ERROR] - NUM_ENCOUNTER_MAKEUPS is %d, but there are %ld makeups\n",
+                NUM_ENCOUNTER_MAKEUPS,
+                makeups);
+        return 1;
+    }
+
+    return wrong > 0;
+}